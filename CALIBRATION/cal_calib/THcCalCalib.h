@@ -0,0 +1,894 @@
+#ifndef ROOT_THcCalCalib
+#define ROOT_THcCalCalib
+
+#include "TH1F.h"
+#include "TH2F.h"
+#include "TF1.h"
+#include "TVectorD.h"
+#include "TMatrixD.h"
+#include "TMatrixDSym.h"
+#include "TDecompChol.h"
+#include "TDecompSVD.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "TFile.h"
+#include "TTree.h"
+#include "TDirectory.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+//
+// Calorimeter calibration core, shared by the HMS (hms_cal_calib) and the
+// SHMS (shms_cal_calib) calibrations: composition of the vectors and matrix
+// of the calibration equations, their solution, and iterations; the
+// thresholds on the uncalibrated Edep/P peak; the parallel reading of a list
+// of runs.
+//
+// The detector classes read the events (OpenTree(), ReadEvents()), and hand
+// the PMT signals of every selected event (energy depositions with unit
+// gains, coordinate corrections included) over to the core by AddPmtEvent().
+// The core is templated on a geometry descriptor Geom, which provides at
+// compile time
+//
+//   fNpmts     total number of PMTs (calibration channels),
+//   fNevThr    max. number of events in the Edep/P and hAdc histograms,
+//   fPosEnorm  count only the events with Edep/P>0 in these histograms,
+//   Hit        the type of the saved hits (fHits).
+//
+
+struct pmt_hit {Double_t signal; UInt_t channel;};
+
+//
+// Compact in-memory copy of the selected events (see ReadEvents()): the tree
+// is read once, and every calibration stage loops over these arrays.
+//
+
+struct cal_event {
+  Double_t p, dp;          // track momentum (GeV), momentum deviation (%)
+  Double_t x, xp, y, yp;   // track at the focal plane
+  UInt_t first_hit;        // index of the first hit in the hit array
+  UInt_t nhits;
+};
+
+struct cal_cutvars {       // cut variables, of all the entries (diagnostic histos)
+  Double_t cer, p, dp, beta, nclust, ntrack;
+};
+
+template <class Geom> class THcCalCalib {
+
+ public:
+
+  static constexpr UInt_t fNpmts = Geom::fNpmts;
+
+  THcCalCalib(string Prefix="", int nstart=0, int nstop=-1);
+  virtual ~THcCalCalib() {};
+
+  virtual void OpenTree() = 0;
+  virtual void ReadEvents() = 0;
+  void ReadRuns();
+  void ComposeVMs();
+  void SolveAlphas();
+  void ResetVMs();
+  void Iterate(UInt_t niter);
+  void SetNthreads(UInt_t n) {fNthreads = TMath::Max(1U, n);};
+
+  Double_t Enorm(UInt_t iev, const Double_t* alpha);
+
+  Double_t GetDeltaMin(){return fDeltaMin;};  
+  Double_t GetDeltaMax(){return fDeltaMax;};  
+  Double_t GetBetaMin(){return fBetaMin;};  
+  Double_t GetBetaMax(){return fBetaMax;};  
+  Double_t GetRatio(){return (Double_t)fNev/fNread;};  
+  string GetTag();
+
+  TH1F **hAdc;         // raw pulse integrals of the selected events
+  TH1F* hEunc;         // Edep/P with the initial gains (see FitThresholds())
+  TH1F* hEuncSel;      // hEunc events within the thresholds
+  TH2F* pmtList;
+
+ protected:
+
+  //
+  // Partial sums of ComposeVMs() over a chunk of events (one per thread).
+  //
+
+  struct vm_sums {
+    Double_t e0;
+    Double_t qe[fNpmts];
+    Double_t q0[fNpmts];
+    Double_t Q[fNpmts][fNpmts];   // upper triangle
+    UInt_t HitCount[fNpmts];
+    UInt_t Nev;
+    TH2F* pmtList;
+  };
+
+  void InitVMs();
+  void ClearPmtEvents();
+  void AddPmtEvent(Double_t p, const pmt_hit* hits, UInt_t nhits);
+  void AddPmtEvents(const THcCalCalib<Geom> &other);
+  void ComposeVMsChunk(UInt_t first, UInt_t last, vm_sums &sums);
+  virtual void PrintHitCounts() {};
+  virtual THcCalCalib<Geom>* NewReader(string run) = 0;
+  Bool_t DiagEvent(Double_t Enorm0=1.);
+  void FitThresholds(Int_t nev);
+
+  static Bool_t FitPeak(TH1F* h, Option_t* opt, Double_t lo, Double_t hi,
+			Double_t &mean, Double_t &sigma);
+
+  static TVectorD SolveRefined(TDecompBase* decomp, const TMatrixDSym &Q,
+			       const TVectorD &b, Bool_t &ok);
+
+  string fPrefix;
+  vector<string> fRuns;            // Prefixes of the runs to calibrate on
+
+  Double_t fDeltaMin, fDeltaMax;   // Delta range, %.
+  Double_t fBetaMin, fBetaMax;     // Beta range
+
+  TFile* fFile;
+  TTree* fTree;
+  UInt_t fNentries;
+  UInt_t fNstart;
+  UInt_t fNstop;
+  Int_t  fNstopRequested;
+  UInt_t fNread;                   // Number of entries read, all runs
+
+  atomic<UInt_t> fNdiagOwn;        // events in hAdc (see DiagEvent()),
+  atomic<UInt_t>* fNdiag;          // shared by the readers of ReadRuns()
+
+  // Events read in by ReadEvents().
+
+  vector<cal_event> fEvents;
+  vector<typename Geom::Hit> fHits;
+  vector<cal_cutvars> fCutVars;
+
+  UInt_t fMinHitCount;             // Min. number of hits/chan. for calibration
+  Double_t fEuncLoLo, fEuncHiHi;   // Range of uncalibrated Edep histogram
+  UInt_t fEuncNBin;                // Binning of uncalibrated Edep histogram
+  Double_t fEuncGFitLo,fEuncGFitHi;// Gaussian fit range of uncalib. Edep histo.
+  Double_t fEuncPeak;              // peak of the uncalib. Edep histo.
+  Double_t sigmaRange;             // range for events to use for calib (e.g +/- 3*sigma)
+
+  Double_t fLoThr;     // Low and high thresholds on the normalized uncalibrated
+  Double_t fHiThr;     // energy deposition.
+  UInt_t fNev;         // Number of processed events.
+  UInt_t fNthreads;    // threads for ComposeVMs()
+
+  // Quantities for calculations of the calibration constants.
+
+  Double_t fe0;
+  Double_t fqe[fNpmts];
+  Double_t fq0[fNpmts];
+  Double_t fQ[fNpmts][fNpmts];
+  Double_t falphaU[fNpmts];   // 'unconstrained' calib. constants
+  Double_t falphaC[fNpmts];   // the sought calibration constants
+  Double_t falpha0[fNpmts];   // initial gains
+  Double_t falpha1[fNpmts];   // unit gains
+  Double_t falphaW[fNpmts];   // gains of the Enorm window (ComposeVMs)
+
+  UInt_t fHitCount[fNpmts];
+
+  // PMT signals of the events (see AddPmtEvent()).
+
+  vector<Double_t> fPmtP;       // track momentum (GeV)
+  vector<UInt_t> fPmtFirst;     // first PMT hit of the event, and end marker
+  vector<pmt_hit> fPmtHits;
+
+};
+
+//------------------------------------------------------------------------------
+
+template <class Geom> THcCalCalib<Geom>::THcCalCalib(string Prefix,
+						   int nstart, int nstop) {
+  fPrefix = Prefix;
+
+  // Several runs can be given as a comma separated list of prefixes.
+
+  istringstream iss(Prefix);
+  string run;
+  while (getline(iss, run, ','))
+    if (!run.empty()) fRuns.push_back(run);
+
+  fFile = 0;
+  fTree = 0;
+  fNentries = 0;
+  fNread = 0;
+  fNstart = nstart;
+  fNstop = 0;            // defined in OpenTree()
+  fNstopRequested = nstop;
+
+  fNdiagOwn = 0;
+  fNdiag = &fNdiagOwn;
+
+  hAdc = 0;
+  hEunc = 0;
+  hEuncSel = 0;
+  pmtList = 0;
+  fNthreads = TMath::Max(1U, thread::hardware_concurrency());
+  fPmtFirst.push_back(0);
+};
+
+//------------------------------------------------------------------------------
+
+template <class Geom> string THcCalCalib<Geom>::GetTag() {
+
+  // Prefix for the output file names; the runs of a list are joined by '+'.
+
+  string tag = fPrefix;
+  replace(tag.begin(), tag.end(), ',', '+');
+  return tag;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> Bool_t THcCalCalib<Geom>::DiagEvent(Double_t Enorm0) {
+
+  //
+  // Whether ReadEvents() fills the selected event in the diagnostic hAdc
+  // histograms: up to Geom::fNevThr events (with Edep/P>0 for the initial
+  // gains, Enorm0, if Geom::fPosEnorm), counted over all the runs of the
+  // list. When the runs are read in parallel, which of their events make it
+  // depends on the timing of the threads.
+  //
+
+  if (Geom::fPosEnorm && !(Enorm0 > 0.)) return *fNdiag <= Geom::fNevThr;
+  return (*fNdiag)++ <= Geom::fNevThr;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::ReadRuns() {
+
+  //
+  // Read the runs of the list in parallel: one reader object (own tree and
+  // branch buffers, see NewReader()) per run, fNthreads runs at a time. The
+  // events of the runs are then appended, in the order of the list, to the
+  // arrays of this object, so that all of them enter the same calibration
+  // equations.
+  //
+
+  UInt_t nruns = fRuns.size();
+  vector<THcCalCalib<Geom>*> readers(nruns);
+
+  TDirectory* dir = gDirectory;   // opening the tree files changes gDirectory
+
+  for (UInt_t ir=0; ir<nruns; ir++) {
+
+    THcCalCalib<Geom>* r = NewReader(fRuns[ir]);   // detector cuts set
+    r->fDeltaMin = fDeltaMin;
+    r->fDeltaMax = fDeltaMax;
+    r->fBetaMin = fBetaMin;
+    r->fBetaMax = fBetaMax;
+    for (UInt_t i=0; i<fNpmts; i++) {
+      r->falpha0[i] = falpha0[i];
+      r->falpha1[i] = falpha1[i];
+    }
+    r->fNdiag = fNdiag;
+
+    r->OpenTree();
+
+    r->hAdc = new TH1F*[fNpmts];
+    for (UInt_t i=0; i<fNpmts; i++) {
+      r->hAdc[i] = (TH1F*)hAdc[i]->Clone(Form("hADC%d_run%d",i,ir));
+      r->hAdc[i]->SetDirectory(0);
+      r->hAdc[i]->Reset();
+    }
+
+    readers[ir] = r;
+  }
+
+  dir->cd();
+
+  UInt_t nthreads = TMath::Min(fNthreads, nruns);
+  if (nthreads > 1) ROOT::EnableThreadSafety();
+
+  vector<thread> threads;
+  for (UInt_t it=0; it<nthreads; it++)
+    threads.push_back( thread([&readers, nruns, nthreads, it]() {
+	  for (UInt_t ir=it; ir<nruns; ir+=nthreads)
+	    readers[ir]->ReadEvents();
+	}) );
+  for (UInt_t it=0; it<nthreads; it++) threads[it].join();
+
+  // Merge. The cut variables are capped as in a single run, over the runs
+  // in the order of the list.
+
+  fEvents.clear();
+  fHits.clear();
+  fCutVars.clear();
+  ClearPmtEvents();
+  fNread = 0;
+  fNentries = 0;
+
+  for (UInt_t ir=0; ir<nruns; ir++) {
+
+    THcCalCalib<Geom>* r = readers[ir];
+
+    UInt_t offset = fHits.size();
+    for (UInt_t iev=0; iev<r->fEvents.size(); iev++) {
+      fEvents.push_back(r->fEvents[iev]);
+      fEvents.back().first_hit += offset;
+    }
+    fHits.insert(fHits.end(), r->fHits.begin(), r->fHits.end());
+
+    for (UInt_t i=0; i<r->fCutVars.size() && fCutVars.size()<=200000; i++)
+      fCutVars.push_back(r->fCutVars[i]);
+
+    AddPmtEvents(*r);
+    fNread += r->fNread;
+    fNentries += r->fNentries;
+
+    for (UInt_t i=0; i<fNpmts; i++) {
+      hAdc[i]->Add(r->hAdc[i]);
+      delete r->hAdc[i];
+    }
+    delete [] r->hAdc;
+
+    delete r->fFile;
+    delete r;
+  }
+
+  cout << "ReadRuns: " << nruns << " runs, " << fEvents.size() << " events, "
+       << fHits.size() << " hits saved" << endl;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> TVectorD THcCalCalib<Geom>::SolveRefined(
+			 TDecompBase* decomp, const TMatrixDSym &Q,
+			 const TVectorD &b, Bool_t &ok) {
+
+  //
+  // Solve Q x = b with the decomposition of Q, plus one step of iterative
+  // refinement (solve Q dx = b - Q x, and correct x).
+  //
+
+  TVectorD x = decomp->Solve(b, ok);
+  if (!ok) return x;
+
+  TVectorD r = b - Q*x;
+  Bool_t ok_r;
+  TVectorD dx = decomp->Solve(r, ok_r);
+  if (ok_r) x += dx;
+
+  return x;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> Bool_t THcCalCalib<Geom>::FitPeak(TH1F* h,
+			Option_t* opt, Double_t lo, Double_t hi,
+			Double_t &mean, Double_t &sigma) {
+
+  //
+  // Gaussian fit of the histogram h in the range lo -- hi. Return false,
+  // and leave mean and sigma untouched, if the fit failed.
+  //
+
+  Int_t status = h->Fit("gaus",opt,"",lo,hi);
+  TF1 *fit = h->GetFunction("gaus");
+
+  if (status != 0 || !fit) {
+    cout << "*** " << h->GetName() << ": gaussian fit in " << lo << " -- "
+	 << hi << " failed, status=" << status << " ***" << endl;
+    return false;
+  }
+
+  fit->SetLineColor(2);
+  fit->SetLineWidth(1);
+  fit->SetLineStyle(1);
+
+  mean  = fit->GetParameter(1);
+  sigma = TMath::Abs(fit->GetParameter(2));
+  return true;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::FitThresholds(Int_t nev) {
+
+  //
+  // Thresholds on the uncalibrated Edep/P (hEunc, filled by the detector
+  // classes' CalcThresholds() with nev events): fit the peak in the range
+  // fEuncGFitLo -- fEuncGFitHi around the max bin, and keep the events
+  // within +/- sigmaRange sigmas. If the fit fails, use the max bin and the
+  // RMS of the histogram instead.
+  //
+
+  Double_t maxBin= hEunc->GetMaximumBin();
+  Double_t maxValue= hEunc->GetBinCenter(maxBin);
+  fEuncPeak=maxValue;
+  fEuncGFitLo=fEuncGFitLo+maxValue;
+  fEuncGFitHi=fEuncGFitHi+maxValue;
+
+  Double_t gmean, gsigma;
+  if (!FitPeak(hEunc, "", fEuncGFitLo, fEuncGFitHi, gmean, gsigma)) {
+    gmean  = maxValue;
+    gsigma = hEunc->GetRMS();
+    cout << "CalcThreshods: using the peak position and the RMS instead"
+	 << endl;
+  }
+  fLoThr = gmean - sigmaRange*gsigma;
+  fHiThr = gmean + sigmaRange*gsigma;
+  cout << "CalcThreshods: fLoThr=" << fLoThr << "  fHiThr=" << fHiThr 
+       << "  nev=" << nev << endl;
+
+  Int_t nbins = hEunc->GetNbinsX();
+  Int_t nlo = hEunc->FindBin(fLoThr);
+  Int_t nhi = hEunc->FindBin(fHiThr);
+
+  cout << "CalcThresholds: nlo=" << nlo << "  nhi=" << nhi 
+       << "  nbins=" << nbins << endl;
+
+  // Histogram of selected within the thresholds events.
+  
+  hEuncSel = (TH1F*)hEunc->Clone("hEuncSel");
+  
+  for (Int_t i=0; i<nlo; i++) hEuncSel->SetBinContent(i, 0.);
+  for (Int_t i=nhi; i<nbins+1; i++) hEuncSel->SetBinContent(i, 0.);
+
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::InitVMs() {
+
+  // Initialize cumulative quantities and the calibration constants; unit
+  // gains, and the Enorm window from the initial gains (see Iterate()).
+
+  ResetVMs();
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+    falphaU[i] = 0.;
+    falphaC[i] = 0.;
+    falpha1[i] = 1.;
+    falphaW[i] = falpha0[i];
+  }
+
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::ClearPmtEvents() {
+  fPmtP.clear();
+  fPmtFirst.assign(1, 0);
+  fPmtHits.clear();
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::AddPmtEvent(Double_t p,
+				       const pmt_hit* hits, UInt_t nhits) {
+
+  //
+  // Save an event: track momentum p (GeV), and the PMT hits with the signals
+  // for unit gains (channels are counted from 1).
+  //
+
+  fPmtP.push_back(p);
+  fPmtHits.insert(fPmtHits.end(), hits, hits+nhits);
+  fPmtFirst.push_back(fPmtHits.size());
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::AddPmtEvents(
+					 const THcCalCalib<Geom> &other) {
+
+  //
+  // Append the saved events of another calibration object (e.g. one read
+  // from another run), so that the events of several runs enter the same
+  // calibration equations.
+  //
+
+  UInt_t offset = fPmtHits.size();
+
+  fPmtP.insert(fPmtP.end(), other.fPmtP.begin(), other.fPmtP.end());
+  fPmtHits.insert(fPmtHits.end(), other.fPmtHits.begin(),
+		  other.fPmtHits.end());
+  for (UInt_t iev=1; iev<other.fPmtFirst.size(); iev++)
+    fPmtFirst.push_back(other.fPmtFirst[iev] + offset);
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> Double_t THcCalCalib<Geom>::Enorm(UInt_t iev,
+						const Double_t* alpha) {
+
+  // Normalized to the track momentum energy deposition of the event iev,
+  // for the gains alpha (same as the tracks' Enorm() after SetEs(alpha)).
+
+  Double_t sum = 0;
+
+  for (UInt_t i=fPmtFirst[iev]; i<fPmtFirst[iev+1]; i++)
+    sum += fPmtHits[i].signal * alpha[fPmtHits[i].channel-1];
+
+  return sum/fPmtP[iev]/1000.;
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::ComposeVMsChunk(UInt_t first,
+					      UInt_t last, vm_sums &sums) {
+
+  //
+  // Accumulate the vectors and matrix of ComposeVMs() over the events
+  // [first,last) into the partial sums (one per thread, no shared state).
+  //
+
+  for (UInt_t iev=first; iev<last; iev++) {
+
+    // Calculate normalized to the track momentum total energy deposition
+    // with the window gains, check it against the thresholds.
+
+    Double_t Enorm = this->Enorm(iev, falphaW);
+    if (Enorm>fLoThr && Enorm<fHiThr) {
+
+      Double_t P = fPmtP[iev]*1000.;   // MeV
+
+      sums.e0 += P;    // Accumulate track momenta.
+
+      UInt_t ifirst = fPmtFirst[iev];
+      UInt_t ilast  = fPmtFirst[iev+1];
+
+      // Fill the qe and q0 vectors, accrue the hit counters.
+
+      for (UInt_t i=ifirst; i<ilast; i++) {
+	UInt_t ic = fPmtHits[i].channel;
+	Double_t is = fPmtHits[i].signal;
+	sums.qe[ic-1] += is * P;
+	sums.q0[ic-1] += is;
+	sums.HitCount[ic-1]++;
+      }
+
+      // Fill in the correlation matrix Q from the PMT hits.
+      // Only the upper triangle is accumulated, Q is symmetrized in ComposeVMs().
+
+      for (UInt_t i=ifirst; i<ilast; i++) {
+
+	UInt_t ic = fPmtHits[i].channel;
+	Double_t is = fPmtHits[i].signal;
+	sums.pmtList->Fill(ic,is);
+
+	for (UInt_t j=i; j<ilast; j++) {
+
+	  UInt_t jc = fPmtHits[j].channel;
+	  Double_t js = fPmtHits[j].signal;
+
+	  if (ic <= jc)
+	    sums.Q[ic-1][jc-1] += is*js;
+	  else
+	    sums.Q[jc-1][ic-1] += is*js;
+	}
+      }
+
+      sums.Nev++;
+
+    };   // if within the thresholds
+
+  };     // over events
+
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::ComposeVMs() {
+
+  //
+  // Fill in vectors and matrixes for the gain constant calculations.
+  //
+  // The events (see AddPmtEvent()) are split in contiguous chunks,
+  // accumulated in parallel (ComposeVMsChunk()), and the partial sums are
+  // added up in chunk order.
+  //
+
+  UInt_t nevents = fPmtP.size();
+  UInt_t nthreads = TMath::Max(1U, TMath::Min(fNthreads, nevents/10000));
+
+  vector<vm_sums*> sums(nthreads);
+  for (UInt_t it=0; it<nthreads; it++) {
+    sums[it] = new vm_sums();         // zero-initialized
+    sums[it]->pmtList = (TH2F*)pmtList->Clone(Form("pmtList_%d",it));
+    sums[it]->pmtList->SetDirectory(0);
+  }
+
+  cout << "ComposeVMs: " << nevents << " events, " << nthreads << " threads"
+       << endl;
+
+  if (nthreads > 1) ROOT::EnableThreadSafety();
+
+  vector<thread> workers;
+  for (UInt_t it=0; it<nthreads; it++) {
+    UInt_t first = (ULong64_t)nevents*it/nthreads;
+    UInt_t last  = (ULong64_t)nevents*(it+1)/nthreads;
+    workers.push_back( thread(&THcCalCalib<Geom>::ComposeVMsChunk, this,
+			      first, last, ref(*sums[it])) );
+  }
+  for (UInt_t it=0; it<nthreads; it++) workers[it].join();
+
+  // Reduce.
+
+  fNev = 0;
+  for (UInt_t it=0; it<nthreads; it++) {
+
+    fe0 += sums[it]->e0;
+    fNev += sums[it]->Nev;
+
+    for (UInt_t i=0; i<fNpmts; i++) {
+      fqe[i] += sums[it]->qe[i];
+      fq0[i] += sums[it]->q0[i];
+      fHitCount[i] += sums[it]->HitCount[i];
+      for (UInt_t j=i; j<fNpmts; j++)
+	fQ[i][j] += sums[it]->Q[i][j];
+    }
+
+    pmtList->Add(sums[it]->pmtList);
+    delete sums[it]->pmtList;
+    delete sums[it];
+  }
+
+  for (UInt_t i=0; i<fNpmts; i++)
+    for (UInt_t j=0; j<i; j++)
+      fQ[i][j] = fQ[j][i];
+
+  // Take averages.
+
+  fe0 /= fNev;
+  for (UInt_t i=0; i<fNpmts; i++) {
+    fqe[i] /= fNev;
+    fq0[i] /= fNev;
+  }
+
+  for (UInt_t i=0; i<fNpmts; i++)
+    for (UInt_t j=0; j<fNpmts; j++)
+      fQ[i][j] /= fNev;
+
+  // Output vectors and matrixes, for debug purposes.
+  /*
+  ofstream q0out;
+  q0out.open("q0.deb",ios::out);
+  for (UInt_t i=0; i<fNpmts; i++)
+    q0out << setprecision(20) << fq0[i] << " " << i << endl;
+  q0out.close();
+
+  ofstream qeout;
+  qeout.open("qe.deb",ios::out);
+  for (UInt_t i=0; i<fNpmts; i++)
+    qeout << setprecision(20) << fqe[i] << " " << i << endl;
+  qeout.close();
+
+  ofstream Qout;
+  Qout.open("Q.deb",ios::out);
+  for (UInt_t i=0; i<fNpmts; i++)
+    for (UInt_t j=0; j<fNpmts; j++)
+      Qout << setprecision(20) << fQ[i][j] << " " << i << " " << j << endl;
+  Qout.close();
+  */
+};
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::SolveAlphas() {
+
+  //
+  // Solve for the sought calibration constants, by use of the Root
+  // matrix algebra package.
+  //
+
+  TMatrixDSym Q(fNpmts);
+  TVectorD q0(fNpmts);
+  TVectorD qe(fNpmts);
+  TVectorD au(fNpmts);
+  TVectorD ac(fNpmts);
+  Bool_t ok;
+
+  cout << "Solving Alphas..." << endl;
+  cout << endl;
+
+  // Print out hit numbers (detector layout).
+
+  PrintHitCounts();
+
+  // Initialize the vectors and the matrix of the Root algebra package.
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+    q0[i] = fq0[i];
+    qe[i] = fqe[i];
+    for (UInt_t k=0; k<fNpmts; k++) {
+      Q[i][k] = fQ[i][k];
+    }
+  }
+
+  // Sanity check.
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+
+    // Check zero hit channels: the vector and matrix elements should be 0.
+
+    if (fHitCount[i] == 0) {
+
+      if (q0[i] != 0. || qe[i] != 0.) {
+
+	cout << "*** Inconsistency in chanel " << i << ": # of hits  "
+	     << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i];
+
+	for (UInt_t k=0; k<fNpmts; k++) {
+	  if (Q[i][k] !=0. || Q[k][i] !=0.)
+	    cout << ", Q[" << i << "," << k << "]=" << Q[i][k]
+		 << ", Q[" << k << "," << i << "]=" << Q[k][i];
+	}
+
+	cout << " ***" << endl;
+      }
+    }
+
+    // The hit channels: the vector elements should be non zero.
+
+    if ( (fHitCount[i] != 0) && (q0[i] == 0. || qe[i] == 0.) ) {
+      cout << "*** Inconsistency in chanel " << i << ": # of hits  "
+	   << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i]
+	   << " ***" << endl;
+    }
+
+  } //sanity check
+
+  // Low hit number channels: exclude from calculation. Assign all the
+  // correspondent elements 0, except self-correlation Q(i,i)=1.
+
+  cout << endl;
+  cout << "Channels with hit number less than " << fMinHitCount
+       << " will not be calibrated." << endl;
+  cout << endl;
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+
+    if (fHitCount[i] < fMinHitCount) {
+      cout << "Channel " << i << ", " << fHitCount[i]
+	   << " hits, will not be calibrated." << endl;
+      q0[i] = 0.;
+      qe[i] = 0.;
+      for (UInt_t k=0; k<fNpmts; k++) {
+	Q[i][k] = 0.;
+	Q[k][i] = 0.;
+      }
+      Q[i][i] = 1.;
+    }
+
+  }
+
+  // Q is symmetric, and positive definite once the low hit channels are
+  // decoupled: use the Cholesky decomposition. Fall back to SVD if Q is
+  // (numerically) singular, e.g. for channels always fired together.
+
+  TDecompBase* decomp = new TDecompChol(Q);
+  if (!decomp->Decompose()) {
+    cout << "SolveAlphas: Cholesky decomposition failed, using SVD" << endl;
+    delete decomp;
+    decomp = new TDecompSVD(TMatrixD(Q));
+    decomp->Decompose();
+  }
+  Double_t d1,d2;
+  decomp->Det(d1,d2);
+  cout << "cond:" << decomp->Condition() << endl;
+  cout << "det :" << d1*TMath::Power(2.,d2) << endl;
+  cout << "tol :" << decomp->GetTol() << endl;
+
+  // Solve equation Q x au = qe for the 'unconstrained' calibration (gain)
+  // constants au.
+
+  au = SolveRefined(decomp, Q, qe, ok);
+  cout << "au: ok=" << ok << endl;
+  //  au.Print();
+
+  // Find the sought 'constrained' calibration constants next.
+
+  Double_t t1 = fe0 - au * q0;         // temporary variable.
+  //  cout << "t1 =" << t1 << endl;
+
+  TVectorD Qiq0(fNpmts);               // an intermittent result
+  Qiq0 = SolveRefined(decomp, Q, q0, ok);
+  cout << "Qiq0: ok=" << ok << endl;
+  //  Qiq0.Print();
+
+  delete decomp;
+
+  Double_t t2 = q0 * Qiq0;             // another temporary variable
+  //  cout << "t2 =" << t2 << endl;
+
+  ac = (t1/t2) *Qiq0 + au;             // the sought gain constants
+  //  cout << "ac:" << endl;
+  //  ac.Print();
+
+  // Assign the gain arrays.
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+    falphaU[i] = au[i];
+    falphaC[i] = ac[i];
+  }
+
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::ResetVMs() {
+
+  // Zero the vectors and matrix accumulated by ComposeVMs().
+
+  fe0 = 0.;
+  fNev = 0;
+
+  for (UInt_t i=0; i<fNpmts; i++) {
+    fqe[i] = 0.;
+    fq0[i] = 0.;
+    fHitCount[i] = 0;
+    for (UInt_t j=0; j<fNpmts; j++) {
+      fQ[i][j] = 0.;
+    }
+  }
+
+  if (pmtList) pmtList->Reset();
+}
+
+//------------------------------------------------------------------------------
+
+template <class Geom> void THcCalCalib<Geom>::Iterate(UInt_t niter) {
+
+  //
+  // Iterate the calibration on the events in memory (no re-reading of the
+  // tree): recompute the Enorm window of the electron peak with the last
+  // calibration constants, recompose the vectors and matrix for the events
+  // within the new window, and solve for the constants again.
+  //
+
+  for (UInt_t iter=1; iter<=niter; iter++) {
+
+    // Normalized energy deposition with the current constants, same event
+    // sample as in CalcThresholds().
+
+    TH1F hE("hEiter", "Edep/P", fEuncNBin, fEuncLoLo, fEuncHiHi);
+    hE.SetDirectory(0);
+
+    UInt_t nev = 0;
+
+    for (UInt_t iev=0; iev<fPmtP.size(); iev++) {
+      Double_t Enorm = this->Enorm(iev, falphaC);
+      if (!Geom::fPosEnorm || Enorm > 0.) {
+	hE.Fill(Enorm);
+	nev++;
+      }
+      if (nev > Geom::fNevThr) break;
+    }
+
+    // Same fit range around the peak as in CalcThresholds().
+
+    // On a failed fit keep the thresholds and constants of the previous
+    // iteration.
+
+    Double_t maxValue = hE.GetBinCenter(hE.GetMaximumBin());
+    Double_t gmean, gsigma;
+    if (!FitPeak(&hE, "0Q", maxValue+fEuncGFitLo-fEuncPeak,
+		 maxValue+fEuncGFitHi-fEuncPeak, gmean, gsigma)) {
+      cout << "Iterate " << iter << ": stopped, fLoThr=" << fLoThr
+	   << "  fHiThr=" << fHiThr << " kept" << endl;
+      break;
+    }
+    fLoThr = gmean - sigmaRange*gsigma;
+    fHiThr = gmean + sigmaRange*gsigma;
+
+    cout << "Iterate " << iter << ": fLoThr=" << fLoThr << "  fHiThr="
+	 << fHiThr << endl;
+
+    for (UInt_t i=0; i<fNpmts; i++) falphaW[i] = falphaC[i];
+
+    ResetVMs();
+    ComposeVMs();
+    SolveAlphas();
+  }
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef THREAD_UTILS_H
+#define THREAD_UTILS_H
+
+//
+// Thread pool helpers shared by the calibration scripts, e.g.
+//
+//   #include "../calib_utils/thread_utils.h"
+//
+
+#include <Rtypes.h>
+#include <TROOT.h>
+#include <TString.h>
+#include <TList.h>
+#include <TChain.h>
+#include <TSelector.h>
+#include <TParameter.h>
+#include <TH1.h>
+#include "Math/MinimizerOptions.h"
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Number of threads to use: nthreads, or one per core if nthreads is 0
+inline UInt_t threadCount(UInt_t nthreads) {
+  if (nthreads == 0) nthreads = std::thread::hardware_concurrency();
+  if (nthreads == 0) nthreads = 1;
+  return nthreads;
+} // threadCount()
+
+// Run task(0), ..., task(ntasks-1) on a pool of nthreads threads
+inline void runOnThreads(UInt_t ntasks, UInt_t nthreads, std::function<void(UInt_t)> task) {
+  std::atomic<UInt_t> next(0);
+  std::vector<std::thread> pool;
+  for (UInt_t ithread = 0; ithread < nthreads; ithread++)
+    pool.push_back(std::thread([&]() {
+	  for (UInt_t itask = next++; itask < ntasks; itask = next++) task(itask);
+	}));
+  for (UInt_t ithread = 0; ithread < pool.size(); ithread++) pool[ithread].join();
+  return;
+} // runOnThreads()
+
+// Run independent fits task(0), ..., task(ntasks-1) on a pool of nthreads threads (0: one per core).
+// The fits use Minuit2, since the old Minuit keeps its state in a global; the default minimizer
+// of the caller is restored afterwards.
+inline void runFitsOnThreads(UInt_t ntasks, UInt_t nthreads, std::function<void(UInt_t)> task) {
+  ROOT::EnableThreadSafety();
+  std::string minimizer = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+  std::string algorithm = ROOT::Math::MinimizerOptions::DefaultMinimizerAlgo();
+  ROOT::Math::MinimizerOptions::SetDefaultMinimizer("Minuit2");
+  runOnThreads(ntasks, threadCount(nthreads), task);
+  ROOT::Math::MinimizerOptions::SetDefaultMinimizer(minimizer.c_str(), algorithm.c_str());
+  return;
+} // runFitsOnThreads()
+
+// Process the chain with the selector (e.g. "calibration.C+") on nthreads threads (0: one per core).
+// Each thread gets its own selector and a contiguous range of entries; the first one reads ch itself,
+// the others their own copy of the chain. The per-slot histograms are then merged into the first
+// selector, which runs Terminate(). Selectors which run their fits on threads read the number of
+// threads from the "nthreads" parameter of the input list.
+// The first selector (and its merged histograms) is handed to the caller, as TChain::Process() keeps
+// it with the chain: it still reads ch, so keep ch alive as long as the selector.
+inline std::unique_ptr<TSelector> runSelectorOnThreads(TChain &ch, const char *selector, TString option, UInt_t nthreads) {
+  std::unique_ptr<TSelector> first_sel(TSelector::GetSelector(selector));
+  if (!first_sel) {
+    std::cout << "Cannot create the selector " << selector << ", the chain is not processed" << std::endl;
+    return first_sel;
+  }
+  nthreads = threadCount(nthreads);
+  Long64_t nentries = ch.GetEntries();
+  if (nentries < nthreads) nthreads = (nentries > 0 ? nentries : 1);
+  ROOT::EnableThreadSafety();
+  // Histograms of different slots share names, keep them out of gDirectory
+  Bool_t addDirectory = TH1::AddDirectoryStatus();
+  TH1::AddDirectory(kFALSE);
+  TList input;
+  input.SetOwner();
+  input.Add(new TParameter<Int_t>("nthreads", nthreads));
+
+  std::vector<TSelector*> slots;
+  std::vector<TChain*> chains;
+  for (UInt_t islot = 0; islot < nthreads; islot++) {
+    TSelector *sel = (islot == 0 ? first_sel.get() : (TSelector*) first_sel->IsA()->New());
+    TChain *slot_ch = &ch;
+    if (islot > 0) {
+      slot_ch = new TChain(ch.GetName());
+      slot_ch->Add(&ch);
+    }
+    sel->SetOption(option);
+    sel->SetInputList(&input);
+    if (islot == 0) sel->Begin(slot_ch);
+    sel->Init(slot_ch);
+    sel->SlaveBegin(slot_ch);
+    slots.push_back(sel);
+    chains.push_back(slot_ch);
+  }
+  runOnThreads(nthreads, nthreads, [&](UInt_t islot) {
+      Long64_t first = nentries*islot/nthreads;
+      Long64_t last = nentries*(islot+1)/nthreads;
+      for (Long64_t entry = first; entry < last; entry++) slots[islot]->Process(entry);
+    });
+
+  // Merge the histograms of all slots into the first one, as PROOF would do with the output lists
+  for (UInt_t islot = 0; islot < nthreads; islot++) {
+    slots[islot]->SlaveTerminate();
+    if (islot == 0) continue;
+    TIter next(slots[islot]->GetOutputList());
+    while (TObject *obj = next()) {
+      TH1 *hist = dynamic_cast<TH1*> (slots[0]->GetOutputList()->FindObject(obj->GetName()));
+      if (hist && obj->InheritsFrom(TH1::Class())) hist->Add((TH1*) obj);
+    }
+    delete slots[islot];
+    delete chains[islot];
+  }
+  slots[0]->Terminate();
+  // The input list goes out of scope here
+  slots[0]->SetInputList(nullptr);
+  TH1::AddDirectory(addDirectory);
+  return first_sel;
+} // runSelectorOnThreads()
+
+#endif
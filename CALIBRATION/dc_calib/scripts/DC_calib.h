@@ -7,6 +7,15 @@
 #define MINBIN -50.0
 #define MAXBIN 350.0
 #define TOTAL_BINS 189  
+
+//selected hit stored by the first pass over the tree, re-binned after the t0 fit
+struct dc_hit
+{
+  Double_t time;      //raw drift time (ns), no offset/t0 subtracted
+  UShort_t plane;
+  UShort_t wire;      //wire number (1 ... nwires)
+};
+
 class DC_calib
 {
  public:
@@ -23,6 +32,7 @@ class DC_calib
   void GetCard();       
   void GetTwentyPercent_Card();  
   void FitCardDriftTime();
+  void FitPlaneCards(Int_t ip);
   void ApplyTZeroCorrectionPerCard(); 
   Double_t GetCardT0_alternative(Int_t ith_plane, Int_t ith_card);
 
@@ -30,20 +40,44 @@ class DC_calib
   void setup_Directory();
   void SetPlaneNames();
   void SetTdcOffset();
-  void GetDCLeafs();
+  void GetDCLeafs(TTree *shared_tree = NULL);
+  void ActivateBranches();
+  TTree *GetTree();
   void AllocateDynamicArrays();
   void CreateHistoNames();
   void EventLoop(string option);
+  void BeginEventLoop();
+  void ProcessEvent();
+  void ApplyT0Correction();
+
+  //HMS and SHMS calibrations from one coin replay (coin_calib.C)
+  static void JointEventLoop(vector<DC_calib*> &calibs);
+  static void CalibrateConcurrently(vector<DC_calib*> &calibs);
+
+  //several replay files (comma separated list of ROOTfiles), read in parallel into one calibration
+  static void RunsEventLoop(vector<DC_calib*> &calibs);
+  void AddRun(DC_calib *run);
   void WriteToFile(Int_t debug);
   // void CalcT0Historical();
   void Calculate_tZero();
   void GetTwentyPercent_Peak();
   void FitWireDriftTime();
+  void FitPlaneWires(Int_t ip);
   void WriteTZeroParam();
   void WriteLookUpTable();
 
   // Helper function
   Double_t GetBetaPeak();
+  void FillCell(Int_t **counts, Double_t **stats, Int_t ip, Int_t iw, Double_t time);
+  TH1F *GetCellHisto(Int_t **counts, Double_t **stats, Int_t ip, Int_t iw, Int_t rebin);
+  void FitLine(const vector<Double_t> &x, const vector<Double_t> &y, Double_t *fit);
+  void FitLineMinuit(TH1F *h, Double_t *fit);
+  void AddFitFunction(TH1F *h, Double_t *fit);
+  void ForEachPlane(void (DC_calib::*method)(Int_t));
+
+  //t0 fit options: threads for the per-plane fits, Minuit instead of the closed-form line fit
+  void SetNthreads(UInt_t n);
+  void UseMinuitFit(Bool_t flag = kTRUE);
   
  private:
 
@@ -92,6 +126,7 @@ class DC_calib
   Bool_t cer_elec;     //cerenkov cut
   Bool_t hod_beta_cut; // cut on beta (mainly for selecting either electrons or protons for calibration)
   Bool_t good_event;    //single hit / event / plane o clean background
+  Double_t beta_peak;   //beta peak of the 50k event sample (GetBetaPeak())
  
   Int_t cnts_ch1;
   Int_t cnts_ch2;
@@ -122,13 +157,11 @@ class DC_calib
   TString cell_dt_name;
   TString cell_dt_title;
 
-  TString fitted_cell_dt_name;
-  TString fitted_cell_dt_title;  
-  
   TString dt_vs_wire_name;
   TString dt_vs_wire_title;
 
   TString ifile_name;
+  vector<TString> input_files;   //replay files of the ifile_name list
   TString ofile_name;
   
   TString itxtfile_name;
@@ -137,12 +170,22 @@ class DC_calib
   //Declare variables to store histograms
   TH1F *plane_dt;
   TH1F *plane_dt_corr;
-  TH1F **cell_dt;
-  TH1F **cell_dt_corr;
-  TH1F **fitted_cell_dt;
   TH2F *dt_vs_wire;
   TH2F *dt_vs_wire_corr;
 
+  //Per-wire drift times: one contiguous [wire][bin] counts buffer per plane
+  //(NBINS+2 bins per wire, incl. under/overflow) and the fill statistics per wire
+  //(sumw, sumw2, sumwx, sumwx2); GetCellHisto() turns a wire into a TH1F when needed
+  Int_t **cell_counts;
+  Int_t **cell_counts_corr;
+  Double_t **cell_stats;
+  Double_t **cell_stats_corr;
+  TAxis *cell_axis;
+  TAxis *fit_axis;      //binning of the fitted (2 ns) cell drift times
+
+  //Selected hits from the first pass (replaces the second pass over the tree)
+  vector<dc_hit> hits;
+
   //Read/Write ROOT files
   TFile *in_file;
   TFile *out_file;
@@ -173,17 +216,13 @@ class DC_calib
   //Declare 'FIT' related variables
   Int_t **entries;               //wire drift time histo entries
   Int_t **entries_card;
-  Int_t binx;
-  Double_t time_init;           //start fit value 
-  Double_t time_final;          //end fit value
-  TF1 *tZero_fit;               //linear fit function
+  TF1 *tZero_fit;               //linear fit function (Minuit fits)
+  Bool_t use_minuit;            //Minuit fits instead of the closed-form line fit
+  UInt_t nthreads;              //threads for the per-plane fits
 
- 
-  Double_t m;                //slope
-  Double_t y_int;            //y-intercept
-  Double_t m_err;
-  Double_t y_int_err;
-  Double_t std_dev;
+  Double_t **wire_fit;       //per wire: fit range (low, high), slope, y-int, their errors, fit status
+  Double_t t0_sum_num[NPLANES];  //per plane sums of the t0 weighted average
+  Double_t t0_sum_den[NPLANES];
   Double_t **t_zero;         
   Double_t **t_zero_err;
   Double_t **t_zero_card;         
@@ -226,10 +265,6 @@ class DC_calib
   Int_t plane_cards[NPLANES];    //number of disc. cards / plane
   Int_t card;
 
-  //GetCardT0_alternative() method variables
-  Double_t maxContent_frac;
-  Double_t card_T0;
-
   //GetTwentyPercent_Card()/Fit Card methods variables
   Int_t binValLow; 
   Int_t binValHigh; 
@@ -265,6 +300,8 @@ class DC_calib
   Int_t **wire_min;
   Int_t **wire_max;
 
+  Double_t **card_fit;       //per card: same as wire_fit
+
 };
 
 
@@ -68,5 +68,3 @@ void THcShHit::Print(ostream & ostrm) {
   ostrm << ADCpos << " " << ADCneg << " " << Epos << " " << Eneg << " "
 	<< BlkNumber << endl;
 };
-
-struct pmt_hit {Double_t signal; UInt_t channel;};
@@ -27,6 +27,7 @@ class THcShTrack {
   Double_t Yp;  // slope
 
   THcShHitList Hits;
+  THcShHitList Spare;   // hit objects of previous events, for reuse
 
  public:
   THcShTrack();
@@ -109,6 +110,9 @@ void THcShTrack::Reset(Double_t p, Double_t dp,
   Xp = xp;
   Y = y;
   Yp =yp;
+
+  // Keep the hit objects for the next event (see AddHit()).
+  Spare.insert(Spare.end(), Hits.begin(), Hits.end());
   Hits.clear();
 };
 
@@ -120,7 +124,17 @@ void THcShTrack::AddHit(Double_t adc_pos, Double_t adc_neg,
 
   // Add a hit to the hit list.
 
-  THcShHit* hit = new THcShHit(adc_pos, adc_neg, blk_number);
+  THcShHit* hit;
+  if (Spare.empty()) {
+    hit = new THcShHit(adc_pos, adc_neg, blk_number);
+  }
+  else {
+    hit = Spare.back();
+    Spare.pop_back();
+    hit->SetADCpos(adc_pos);
+    hit->SetADCneg(adc_neg);
+    hit->SetBlkNumber(blk_number);
+  }
   hit->SetEpos(e_pos);
   hit->SetEneg(e_neg);
   Hits.push_back(hit);
@@ -129,9 +143,7 @@ void THcShTrack::AddHit(Double_t adc_pos, Double_t adc_neg,
 //------------------------------------------------------------------------------
 
 THcShHit* THcShTrack::GetHit(UInt_t k) {
-  THcShHitIt it = Hits.begin();
-  for (UInt_t i=0; i<k; i++) it++;
-  return *it;
+  return Hits[k];
 }
 
 void THcShTrack::Print(ostream & ostrm) {
@@ -154,6 +166,10 @@ THcShTrack::~THcShTrack() {
     delete *i;
     *i = 0;
   }
+  for (THcShHitIt i = Spare.begin(); i != Spare.end(); ++i) {
+    delete *i;
+    *i = 0;
+  }
 };
 
 //------------------------------------------------------------------------------
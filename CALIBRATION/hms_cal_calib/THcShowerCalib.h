@@ -2,21 +2,23 @@
 #define ROOT_THcShowerCalib
 
 #include "THcShTrack.h"
+#include "../cal_calib/THcCalCalib.h"
 #include "TH1F.h"
 #include "TH2F.h"
-#include "TVectorD.h"
-#include "TMatrixD.h"
-#include "TDecompLU.h"
-#include "TDecompSVD.h"
+#include "TF1.h"
 #include "TMath.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <thread>
 
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TDirectory.h"
 
 #define D_CALO_FP 338.69    //distance from FP to the calorimeter face
 #define D_DPEXIT_FP -147.48    //distance from FP to the dipole exit
@@ -29,11 +31,27 @@
 
 using namespace std;
 
+struct sh_hit {             // saved hits of the events (see ReadEvents())
+  Double_t adc_pos, adc_neg;
+  UInt_t blk;
+};
+
+//
+// HMS calorimeter descriptor for the calibration core (THcCalCalib.h).
+//
+
+struct THcShGeom {
+  static constexpr UInt_t fNpmts = THcShTrack::fNpmts;
+  static constexpr UInt_t fNevThr = 200000;   // as in CalcThresholds()
+  static constexpr bool fPosEnorm = false;
+  typedef sh_hit Hit;
+};
+
 //
 // HMS Shower Counter calibration class.
 //
 
-class THcShowerCalib {
+class THcShowerCalib : public THcCalCalib<THcShGeom> {
 
  public:
   THcShowerCalib(string, int, int);
@@ -42,25 +60,20 @@ class THcShowerCalib {
 
   void ReadThresholds();
   void Init();
+  void OpenTree();
   bool ReadShRawTrack(THcShTrack &trk, UInt_t ientry);
+  void ReadEvents();
+  void GetShTrack(THcShTrack &trk, UInt_t iev);
   void CalcThresholds();
-  void ComposeVMs();
-  void SolveAlphas();
+  void PrintHitCounts();
   void FillHEcal();
   void FillHEcalNoCor();
   void SaveAlphas();
   void SaveRawData();
   void FillCutBranch();
   void FillHitsGains();
-  Double_t GetDeltaMin(){return fDeltaMin;};  
-  Double_t GetDeltaMax(){return fDeltaMax;};  
-  Double_t GetBetaMin(){return fBetaMin;};  
-  Double_t GetBetaMax(){return fBetaMax;};  
   Double_t GetCerMin(){return fCerMin;};  
-  Double_t GetRatio(){return (Double_t)fNev/(fNstop-fNstart);};  
 
-  TH1F* hEunc;
-  TH1F* hEuncSel;
   TH1F* hEcal;
   TH1F* hEcalNoCor;
   TH2F* hDPvsEcal;
@@ -87,35 +100,15 @@ class THcShowerCalib {
   TH2F* ta2a;
   TH2F* ta3a;
   TH2F* ta4a;
-  TH2F* pmtList;
   TH2F* cMat;
   TH2F* yCalVsEp;
   TH2F* xCalVsEp;
- 
-  TH1F **hAdc;
 
  private:
 
-  string fPrefix;
+  THcCalCalib<THcShGeom>* NewReader(string run);
 
-  Double_t fDeltaMin, fDeltaMax;   // Delta range, %.
-  Double_t fBetaMin, fBetaMax;     // Beta range
   Double_t fCerMin;                // Threshold Cerenkov signal, p.e.
-  UInt_t fMinHitCount;             // Min. number of hits/chan. for calibration
-  Double_t fEuncLoLo, fEuncHiHi;   // Range of uncalibrated Edep histogram
-  UInt_t fEuncNBin;                // Binning of uncalibrated Edep histogram
-  Double_t fEuncGFitLo,fEuncGFitHi;// Gaussian fit range of uncalib. Edep histo.
-  Double_t sigmaRange;             // range for events to use for calib (e.g +/- 3*sigma)
-
-  Double_t fLoThr;     // Low and high thresholds on the normalized uncalibrated
-  Double_t fHiThr;     // energy deposition.
-  UInt_t fNev;         // Number of processed events.
-
-  TTree* fTree;
-  UInt_t fNentries;
-  UInt_t fNstart;
-  UInt_t fNstop;
-  Int_t  fNstopRequested;
 
   // Declaration of leaves types
 
@@ -177,19 +170,6 @@ class THcShowerCalib {
 
   TBranch* b_H_cal_nclust;
 
-  // Quantities for calculations of the calibration constants.
-
-  Double_t fe0;
-  Double_t fqe[THcShTrack::fNpmts];
-  Double_t fq0[THcShTrack::fNpmts];
-  Double_t fQ[THcShTrack::fNpmts][THcShTrack::fNpmts];
-  Double_t falphaU[THcShTrack::fNpmts];   // 'unconstrained' calib. constants
-  Double_t falphaC[THcShTrack::fNpmts];   // the sought calibration constants
-  Double_t falpha0[THcShTrack::fNpmts];   // initial gains
-  Double_t falpha1[THcShTrack::fNpmts];   // unit gains
-
-  UInt_t fHitCount[THcShTrack::fNpmts];
-
 };
 
 //------------------------------------------------------------------------------
@@ -198,12 +178,8 @@ THcShowerCalib::THcShowerCalib() {};
 
 //------------------------------------------------------------------------------
 
-THcShowerCalib::THcShowerCalib(string Prefix, int nstart, int nstop) {
-  fPrefix = Prefix;
-  fNstart = nstart;
-  //  fNstop = nstop;       //defined in Init
-  fNstopRequested = nstop;
-};
+THcShowerCalib::THcShowerCalib(string Prefix, int nstart, int nstop) :
+  THcCalCalib<THcShGeom>(Prefix, nstart, nstop) {};
 
 //------------------------------------------------------------------------------
 
@@ -224,13 +200,10 @@ void THcShowerCalib::SaveRawData() {
 
   THcShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
-
-    if (ReadShRawTrack(trk, ientry)) {
-      trk.SetEs(falphaC);
-      trk.Print(fout);
-    }
-
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
+    GetShTrack(trk, iev);
+    trk.SetEs(falphaC);
+    trk.Print(fout);
   }
 
   fout.close();
@@ -350,16 +323,84 @@ void THcShowerCalib::ReadThresholds() {
 
 void THcShowerCalib::Init() {
 
-  //Reset ROOT and connect tree file.
+  //Reset ROOT and connect tree file (or the files of several runs, which
+  //are read in parallel by ReadRuns()).
 
   gROOT->Reset();
 
-    char* fname = Form("ROOTfiles/%s.root",fPrefix.c_str());
+  if (fRuns.size() == 1)
+    OpenTree();
+  else
+    cout << "THcShowerCalib::Init: " << fRuns.size() << " runs, entries "
+	 << fNstart << " -- " << fNstopRequested << " of each" << endl;
+
+  // Histogram declarations.
+
+  hEunc = new TH1F("hEunc","Edep/P uncalibrated",fEuncNBin,fEuncLoLo,fEuncHiHi);
+  hEcal = new TH1F("hEcal", "Edep/P calibrated", 200, 0.05, 2.);
+  hEcalNoCor = new TH1F("hEcalNoCor", "Edep/P calibrated without Y-corr.", 200, 0.05, 2.);
+  hCer = new TH1F("hCer","H.cer.npeSum",210, -0.5, 20.5);
+  hP = new TH1F("hP","H.gtr.p",100, 0, 12);
+  hDelta = new TH1F("hDelta","H.gtr.dp",100, -12, 12);
+  hBeta = new TH1F("hBeta","H.hod.beta",100, 0, 2);
+  hNtrack = new TH1F("hNtrack","H.dc.ntrack",51, -0.5, 50.5);
+  hNclust = new TH1F("hNclust","H.cal.nclust",21, -0.5, 20.5);
+
+  hDPvsEcal = new TH2F("hDPvsEcal", "#DeltaP versus Edep/P ",
+		       150,0.,1.5, 250,-12.5,12.5);
+  hETAvsEPR = new TH2F("hETAvsEPR", "E_{TA} versus E_{PR}",
+		       300,0.,1.5, 300,0.,1.5);
+  Double_t padH=(XMAX - XMIN)/13; //Paddle Height
+
+  //100,YMIN-10, YMAX+10, 100, XMIN-10, XMAX+10);
+  hCaloPos = new TH2F("hCaloPos", "Tracks Projected to Calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
+  hCaloPosWt = new TH2F("hCaloPosWt", "e/p weighted",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
+  hCaloPosNorm = new TH2F("hCaloPosNorm", "Calibrated E/p at calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
+  hCaloPosWtU = new TH2F("hCaloPosWtU", "e/p weighted",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
+  hCaloPosNormU = new TH2F("hCaloPosNormU", "Uncalibrated E/p at calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
+  hExitPos = new TH2F("hExitPos", "Tracks Projected to Dipole Exit",100,-50, 50, 100, -50, 50);
+  hClusTrk = new TH2F("hClusTrk","nTracks vs nClusters",9,-0.5,8.5, 41,-0.5,40.5);
+
+  pr1= new TH2F("pr1","Preshower (Layer1)",2, .5, 2.5, 13, 0.5, 13.5);
+  ta2= new TH2F("ta2","Shower (Layer2)"   ,2, .5, 2.5, 13, 0.5, 13.5);
+  ta3= new TH2F("ta3","Shower (Layer3)"   ,1, .5, 1.5, 13, 0.5, 13.5);
+  ta4= new TH2F("ta4","Shower (Layer4)"   ,1, .5, 1.5, 13, 0.5, 13.5);
+
+  pr1a= new TH2F("pr1a","Preshower (Layer1)",2, .8, 2.8, 13, 0.5, 13.5);
+  ta2a= new TH2F("ta2a","Shower (Layer2)"   ,2, .8, 2.8, 13, 0.5, 13.5);
+  ta3a= new TH2F("ta3a","Shower (Layer3)"   ,1, .7, 1.7, 13, 0.5, 13.5);
+  ta4a= new TH2F("ta4a","Shower (Layer4)"   ,1, .7, 1.7, 13, 0.5, 13.5);
+
+  cMat= new TH2F("cMat","Correlation Matrix",   78,-0.5,77.5,78,-0.5,77.5);
+
+  pmtList= new TH2F("pmtList","Signal vs Block# of pmt_hits_list",   79,-0.5,78.5, 100, 0, 250);
+  yCalVsEp = new TH2F("yCalVsEp","Y_calo vs E/p", 150, 0, 1.5, 100,YMIN-10,YMAX+10);
+  xCalVsEp = new TH2F("xCalVsEp","X_calo vs E/p", 150, 0, 1.5, 54, XMIN-padH/4, XMAX+padH/4);
+  hAdc = new TH1F*[THcShTrack::fNpmts];
+  for(UInt_t i=0; i<THcShTrack::fNpmts; i++){hAdc[i]=new TH1F(Form("hADC%d",i),"pulseInts",25,0.1,250);}
+
+  // Initialize cumulative quantities and gains.
+
+  InitVMs();
+
+  // Single pass over the tree.
+
+  ReadEvents();
+
+};
+
+//------------------------------------------------------------------------------
+
+void THcShowerCalib::OpenTree() {
+
+  // Connect the tree file of the run fPrefix, and set branch addresses.
+
+  char* fname = Form("ROOTfiles/%s.root",fPrefix.c_str());
   //   char* fname = Form("kaonRoot/%s.root",fPrefix.c_str());
  cout << "THcShowerCalib::Init: Root file name = " << fname << endl;
 
-  TFile *f = new TFile(fname);
-  f->GetObject("T",fTree);
+  fFile = new TFile(fname);
+  fFile->GetObject("T",fTree);
 
   fNentries = fTree->GetEntries();
   cout << "THcShowerCalib::Init: fNentries= " << fNentries << endl;
@@ -414,74 +455,7 @@ void THcShowerCalib::Init() {
 
   fTree->SetBranchAddress("H.cal.nclust", &H_cal_nclust,&b_H_cal_nclust);
 
-  // Histogram declarations.
-
-  hEunc = new TH1F("hEunc","Edep/P uncalibrated",fEuncNBin,fEuncLoLo,fEuncHiHi);
-  hEcal = new TH1F("hEcal", "Edep/P calibrated", 200, 0.05, 2.);
-  hEcalNoCor = new TH1F("hEcalNoCor", "Edep/P calibrated without Y-corr.", 200, 0.05, 2.);
-  hCer = new TH1F("hCer","H.cer.npeSum",210, -0.5, 20.5);
-  hP = new TH1F("hP","H.gtr.p",100, 0, 12);
-  hDelta = new TH1F("hDelta","H.gtr.dp",100, -12, 12);
-  hBeta = new TH1F("hBeta","H.hod.beta",100, 0, 2);
-  hNtrack = new TH1F("hNtrack","H.dc.ntrack",51, -0.5, 50.5);
-  hNclust = new TH1F("hNclust","H.cal.nclust",21, -0.5, 20.5);
-
-  hDPvsEcal = new TH2F("hDPvsEcal", "#DeltaP versus Edep/P ",
-		       150,0.,1.5, 250,-12.5,12.5);
-  hETAvsEPR = new TH2F("hETAvsEPR", "E_{TA} versus E_{PR}",
-		       300,0.,1.5, 300,0.,1.5);
-  Double_t padH=(XMAX - XMIN)/13; //Paddle Height
-
-  //100,YMIN-10, YMAX+10, 100, XMIN-10, XMAX+10);
-  hCaloPos = new TH2F("hCaloPos", "Tracks Projected to Calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
-  hCaloPosWt = new TH2F("hCaloPosWt", "e/p weighted",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
-  hCaloPosNorm = new TH2F("hCaloPosNorm", "Calibrated E/p at calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
-  hCaloPosWtU = new TH2F("hCaloPosWtU", "e/p weighted",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
-  hCaloPosNormU = new TH2F("hCaloPosNormU", "Uncalibrated E/p at calorimeter",100,YMIN-10, YMAX+10,54, XMIN-padH/4, XMAX+padH/4);
-  hExitPos = new TH2F("hExitPos", "Tracks Projected to Dipole Exit",100,-50, 50, 100, -50, 50);
-  hClusTrk = new TH2F("hClusTrk","nTracks vs nClusters",9,-0.5,8.5, 41,-0.5,40.5);
-
-  pr1= new TH2F("pr1","Preshower (Layer1)",2, .5, 2.5, 13, 0.5, 13.5);
-  ta2= new TH2F("ta2","Shower (Layer2)"   ,2, .5, 2.5, 13, 0.5, 13.5);
-  ta3= new TH2F("ta3","Shower (Layer3)"   ,1, .5, 1.5, 13, 0.5, 13.5);
-  ta4= new TH2F("ta4","Shower (Layer4)"   ,1, .5, 1.5, 13, 0.5, 13.5);
-
-  pr1a= new TH2F("pr1a","Preshower (Layer1)",2, .8, 2.8, 13, 0.5, 13.5);
-  ta2a= new TH2F("ta2a","Shower (Layer2)"   ,2, .8, 2.8, 13, 0.5, 13.5);
-  ta3a= new TH2F("ta3a","Shower (Layer3)"   ,1, .7, 1.7, 13, 0.5, 13.5);
-  ta4a= new TH2F("ta4a","Shower (Layer4)"   ,1, .7, 1.7, 13, 0.5, 13.5);
-
-  cMat= new TH2F("cMat","Correlation Matrix",   78,-0.5,77.5,78,-0.5,77.5);
-
-  pmtList= new TH2F("pmtList","Signal vs Block# of pmt_hits_list",   79,-0.5,78.5, 100, 0, 250);
-  yCalVsEp = new TH2F("yCalVsEp","Y_calo vs E/p", 150, 0, 1.5, 100,YMIN-10,YMAX+10);
-  xCalVsEp = new TH2F("xCalVsEp","X_calo vs E/p", 150, 0, 1.5, 54, XMIN-padH/4, XMAX+padH/4);
-  hAdc = new TH1F*[THcShTrack::fNpmts];
-  for(UInt_t i=0; i<THcShTrack::fNpmts; i++){hAdc[i]=new TH1F(Form("hADC%d",i),"pulseInts",25,0.1,250);}
-
-  // Initialize qumulative quantities.
-  
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) fHitCount[i] = 0;
-
-  fe0 = 0.;
-
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-    fqe[i] = 0.;
-    fq0[i] = 0.;
-    falphaU[i] = 0.;
-    falphaC[i] = 0.;
-    for (UInt_t j=0; j<THcShTrack::fNpmts; j++) {
-      fQ[i][j] = 0.;
-    }
-  }
-
-  // Unit gains.
-
-  for (UInt_t ipmt=0; ipmt<THcShTrack::fNpmts; ipmt++) {
-    falpha1[ipmt] = 1.;
-  }
-
-};
+}
 
 //------------------------------------------------------------------------------
 
@@ -497,58 +471,27 @@ void THcShowerCalib::CalcThresholds() {
   Int_t nev = 0;
   THcShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
 
-    if (ReadShRawTrack(trk, ientry)) {
+    GetShTrack(trk, iev);
 
-      //    trk.Print(cout);
-      //    getchar();
+    //    trk.Print(cout);
+    //    getchar();
 
-      trk.SetEs(falpha0);             //Use initial gain constants here.
-      Double_t Enorm = trk.Enorm();
+    trk.SetEs(falpha0);             //Use initial gain constants here.
+    Double_t Enorm = trk.Enorm();
 
-      hEunc->Fill(Enorm);    
+    hEunc->Fill(Enorm);    
 
-      nev++;
-      //    cout << "CalcThreshods: nev=" << nev << "  Enorm=" << Enorm << endl;
-    }
+    nev++;
+    //    cout << "CalcThreshods: nev=" << nev << "  Enorm=" << Enorm << endl;
 
     if (nev > 200000) break;
   };
-  //wph modifing the code to fit +/- sigma from peak
-  //Double_t max
-
-
-  //  hEunc->Fit("gaus","0","",0.5, 1.5);
-  Double_t maxBin= hEunc->GetMaximumBin();
-  Double_t maxValue= hEunc->GetBinCenter(maxBin);
-  fEuncGFitLo=fEuncGFitLo+maxValue;
-  fEuncGFitHi=fEuncGFitHi+maxValue;
-  hEunc->Fit("gaus","","",fEuncGFitLo, fEuncGFitHi);
-  hEunc->GetFunction("gaus")->SetLineColor(2);
-  hEunc->GetFunction("gaus")->SetLineWidth(1);
-  hEunc->GetFunction("gaus")->SetLineStyle(1);
-  TF1 *fit = hEunc->GetFunction("gaus");
-  Double_t gmean  = fit->GetParameter(1);
-  Double_t gsigma = fit->GetParameter(2);
-  fLoThr = gmean - sigmaRange*gsigma;
-  fHiThr = gmean + sigmaRange*gsigma;
-  cout << "CalcThreshods: fLoThr=" << fLoThr << "  fHiThr=" << fHiThr 
-       << "  nev=" << nev << endl;
-
-  Int_t nbins = hEunc->GetNbinsX();
-  Int_t nlo = hEunc->FindBin(fLoThr);
-  Int_t nhi = hEunc->FindBin(fHiThr);
-
-  cout << "CalcThresholds: nlo=" << nlo << "  nhi=" << nhi 
-       << "  nbins=" << nbins << endl;
-
-  // Histogram selected wthin the thresholds events.
-  
-  hEuncSel = (TH1F*)hEunc->Clone("hEuncSel");
-  
-  for (Int_t i=0; i<nlo; i++) hEuncSel->SetBinContent(i, 0.);
-  for (Int_t i=nhi; i<nbins+1; i++) hEuncSel->SetBinContent(i, 0.);
+
+  // Fit the peak (range specified in input.dat), set the thresholds.
+
+  FitThresholds(nev);
 
 };
 
@@ -637,160 +580,123 @@ bool THcShowerCalib::ReadShRawTrack(THcShTrack &trk, UInt_t ientry) {
 
 //------------------------------------------------------------------------------
 
-void THcShowerCalib::ComposeVMs() {
+void THcShowerCalib::ReadEvents() {
 
   //
-  // Fill in vectors and matrixes for the gain constant calculations.
+  // Read the tree ONCE: save the selected shower track events (track
+  // parameters and hits, see ReadShRawTrack()) in fEvents/fHits, and the cut
+  // variables of the first entries in fCutVars. All the calibration stages
+  // loop over these arrays instead of re-reading the tree.
   //
 
-  fNev = 0;
-  THcShTrack trk;
-
-  // Loop over the shower track events in the ntuples.
-
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
-
-    if (ReadShRawTrack(trk, ientry)) {
+  if (fRuns.size() > 1) {
+    ReadRuns();
+    return;
+  }
 
-      // Set energy depositions with default gains.
-      // Calculate normalized to the track momentum total energy deposition,
-      // check it against the thresholds.
+  fEvents.clear();
+  fHits.clear();
+  fCutVars.clear();
+  ClearPmtEvents();
 
-      trk.SetEs(falpha0);
-      Double_t Enorm = trk.Enorm();
-      if (Enorm>fLoThr && Enorm<fHiThr) {
+  THcShTrack trk;
+  pmt_hit pmt_hit_list[THcShTrack::fNpmts];   // PMT hits of the track
 
-	trk.SetEs(falpha1);   // Set energies with unit gains for now.
-	// trk.Print(cout);
+  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
 
-	fe0 += trk.GetP();    // Accumulate track momenta.
+    bool good = ReadShRawTrack(trk, ientry);   // reads in the entry
 
-	vector<pmt_hit> pmt_hit_list;     // Container to save PMT hits
+    if (fCutVars.size() <= 200000)
+      fCutVars.push_back( cal_cutvars{H_cer_npeSum, H_tr_p, H_tr_tg_dp,
+	    H_tr_beta, H_cal_nclust, H_tr_n} );
 
-	// Loop over hits.
+    if (!good) continue;
 
-	for (UInt_t i=0; i<trk.GetNhits(); i++) {
+    // Raw pulse integrals of the selected events (for FillHEcal()).
 
-	  THcShHit* hit = trk.GetHit(i);
-	  //hit->Print(cout);
-	  
-	  UInt_t nb = hit->GetBlkNumber();
+    if (DiagEvent()) {
+      for(UInt_t i=0; i< THcShTrack::fNrows; i++) {
+	hAdc[i]->Fill(H_cal_1pr_apos_p[i]);
+	hAdc[i+13]->Fill(H_cal_1pr_aneg_p[i]);
+	hAdc[i+26]->Fill(H_cal_2ta_apos_p[i]);
+	hAdc[i+39]->Fill(H_cal_2ta_aneg_p[i]);
+	hAdc[i+52]->Fill(H_cal_3ta_apos_p[i]);
+	hAdc[i+65]->Fill(H_cal_4ta_apos_p[i]);
+      }
+    }
 
-	  // Fill the qe and q0 vectors (for positive side PMT).
+    fEvents.push_back( cal_event{H_tr_p, H_tr_tg_dp, H_tr_x, H_tr_xp,
+	  H_tr_y, H_tr_yp, (UInt_t)fHits.size(), trk.GetNhits()} );
 
-	  fqe[nb-1] += hit->GetEpos() * trk.GetP();
-	  fq0[nb-1] += hit->GetEpos();
+    for (UInt_t i=0; i<trk.GetNhits(); i++) {
+      THcShHit* hit = trk.GetHit(i);
+      fHits.push_back( sh_hit{hit->GetADCpos(), hit->GetADCneg(),
+	    hit->GetBlkNumber()} );
+    }
 
-	  // Save the PMT hit.
+    // PMT signals with unit gains, positive and negative sides, for the
+    // calibration core.
 
-	  pmt_hit_list.push_back( pmt_hit{hit->GetEpos(), nb} );
+    trk.SetEs(falpha1);
 
-	  fHitCount[nb-1]++;   //Accrue the hit counter.
+    UInt_t npmt_hits = 0;
 
-	  // Do same for the negative side PMTs.
+    for (UInt_t i=0; i<trk.GetNhits(); i++) {
 
-	  if (nb <= THcShTrack::fNnegs) {
-	    fqe[THcShTrack::fNblks+nb-1] += hit->GetEneg() * trk.GetP();
-	    fq0[THcShTrack::fNblks+nb-1] += hit->GetEneg();
+      THcShHit* hit = trk.GetHit(i);
+      UInt_t nb = hit->GetBlkNumber();
 
-	    pmt_hit_list.push_back(pmt_hit{hit->GetEneg(),
-		  THcShTrack::fNblks+nb} );
+      pmt_hit_list[npmt_hits++] = pmt_hit{hit->GetEpos(), nb};
 
-	    fHitCount[THcShTrack::fNblks+nb-1]++;
-	  };
+      if (nb <= THcShTrack::fNnegs)
+	pmt_hit_list[npmt_hits++] = pmt_hit{hit->GetEneg(),
+					    THcShTrack::fNblks+nb};
+    }
 
-	}      //over hits
+    AddPmtEvent(H_tr_p, pmt_hit_list, npmt_hits);
 
-	// Fill in the correlation matrix Q by retrieving the PMT hits.
-	
-	for (vector<pmt_hit>::iterator i=pmt_hit_list.begin();
-	     i < pmt_hit_list.end(); i++) {
+  }
 
-	  UInt_t ic = (*i).channel;
-	  Double_t is = (*i).signal;
-	  pmtList->Fill(ic,is);
+  fNread = fNstop - fNstart;
 
-	  for (vector<pmt_hit>::iterator j=i;
-	       j < pmt_hit_list.end(); j++) {
+  cout << "ReadEvents: " << fPrefix << ": " << fEvents.size() << " events, "
+       << fHits.size() << " hits saved" << endl;
+}
 
-	    UInt_t jc = (*j).channel;
-	    Double_t js = (*j).signal;
+//------------------------------------------------------------------------------
 
+THcCalCalib<THcShGeom>* THcShowerCalib::NewReader(string run) {
 
-	    fQ[ic-1][jc-1] += is*js;
-	    if (jc != ic) fQ[jc-1][ic-1] += is*js;
-	  }
-	}
+  // Reader of one run of the list (see ReadRuns()), with the Cerenkov cut of
+  // this object; the common cuts and gains are set by ReadRuns().
 
-	fNev++;
+  THcShowerCalib* r = new THcShowerCalib(run, fNstart, fNstopRequested);
+  r->fCerMin = fCerMin;
+  return r;
+}
 
-      };   // if within the thresholds
+//------------------------------------------------------------------------------
 
-    };   // success in reading
+void THcShowerCalib::GetShTrack(THcShTrack &trk, UInt_t iev) {
 
-  };     // over entries
+  //
+  // Set a Shower track from the saved event iev (same as ReadShRawTrack()).
+  //
 
-  // Take averages.
+  cal_event &ev = fEvents[iev];
 
-  fe0 /= fNev;
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-    fqe[i] /= fNev;
-    fq0[i] /= fNev;
-  }
+  trk.Reset(ev.p, ev.dp, ev.x+D_CALO_FP*ev.xp, ev.xp,
+	    ev.y+D_CALO_FP*ev.yp, ev.yp);
 
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++)
-    for (UInt_t j=0; j<THcShTrack::fNpmts; j++)
-      fQ[i][j] /= fNev;
-
-
-  //Histogram correlation matrix
-  //  for (UInt_t i=0; i<THcShTrack::fNpmts; i++)
-  //    for (UInt_t j=0; j<THcShTrack::fNpmts; j++)
-  //      cMat->Fill(j,i,fQ[i][j]);
-
-  // Output vectors and matrixes, for debug purposes.
-  /*  
-  ofstream q0out;
-  q0out.open("q0.deb",ios::out);
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++)
-    q0out << fq0[i] << " " << i << endl;
-  q0out.close();
-
-  ofstream qeout;
-  qeout.open("qe.deb",ios::out);
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++)
-    qeout << fqe[i] << " " << i << endl;
-  qeout.close();
-
-  ofstream Qout;
-  Qout.open("Q.deb",ios::out);
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++)
-    for (UInt_t j=0; j<THcShTrack::fNpmts; j++)
-      Qout << fQ[i][j] << " " << i << " " << j << endl;
-  Qout.close();
-  */
-};
+  for (UInt_t i=ev.first_hit; i<ev.first_hit+ev.nhits; i++)
+    trk.AddHit(fHits[i].adc_pos, fHits[i].adc_neg, 0., 0., fHits[i].blk);
+}
 
 //------------------------------------------------------------------------------
 
-void THcShowerCalib::SolveAlphas() {
+void THcShowerCalib::PrintHitCounts() {
 
-  //
-  // Solve for the sought calibration constants, by use of the Root
-  // matrix algebra package.
-  //
-
-  TMatrixD Q(THcShTrack::fNpmts,THcShTrack::fNpmts);
-  TVectorD q0(THcShTrack::fNpmts);
-  TVectorD qe(THcShTrack::fNpmts);
-  TVectorD au(THcShTrack::fNpmts);
-  TVectorD ac(THcShTrack::fNpmts);
-  Bool_t ok;
-
-  cout << "Solving Alphas..." << endl;
-  cout << endl;
-
-  // Print out hit numbers.
+  // Print out hit numbers, positive and negative side PMTs.
 
   cout << "Hit counts:" << endl;
   UInt_t j = 0;
@@ -812,115 +718,6 @@ void THcShowerCalib::SolveAlphas() {
   for (UInt_t i=0; i<THcShTrack::fNrows; i++)
     cout << setw(6) << fHitCount[j++] << ",";
   cout << endl;
-
-  // Initialize the vectors and the matrix of the Root algebra package.
-
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-    q0[i] = fq0[i];
-    qe[i] = fqe[i];
-    for (UInt_t k=0; k<THcShTrack::fNpmts; k++) {
-      Q[i][k] = fQ[i][k];
-    }
-  }
-  //  Q.Print();//wph
-  // Sanity check.
-
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-
-    // Check zero hit channels: the vector and matrix elements should be 0.
-
-    if (fHitCount[i] == 0) {
-
-      if (q0[i] != 0. || qe[i] != 0.) {
-
-	cout << "*** Inconsistency in chanel " << i << ": # of hits  "
-	     << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i];
-
-	for (UInt_t k=0; k<THcShTrack::fNpmts; k++) {
-	  if (Q[i][k] !=0. || Q[k][i] !=0.)
-	    cout << ", Q[" << i << "," << k << "]=" << Q[i][k]
-		 << ", Q[" << k << "," << i << "]=" << Q[k][i];
-	}
-
-	cout << " ***" << endl;
-      }
-    }
-
-    // The hit channels: the vector elements should be non zero.
-
-    if ( (fHitCount[i] != 0) && (q0[i] == 0. || qe[i] == 0.) ) {
-      cout << "*** Inconsistency in chanel " << i << ": # of hits  "
-	   << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i]
-	   << " ***" << endl;
-    }
-
-  } //sanity check
-
-  // Low hit number channels: exclude from calculation. Assign all the
-  // correspondent elements 0, except self-correlation Q(i,i)=1.
-
-  cout << endl;
-  cout << "Channels with hit number less than " << fMinHitCount
-       << " will not be calibrated." << endl;
-  cout << endl;
-
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-
-    if (fHitCount[i] < fMinHitCount) {
-      cout << "Channel " << i << ", " << fHitCount[i]
-	   << " hits, will not be calibrated." << endl;
-      q0[i] = 0.;
-      qe[i] = 0.;
-      for (UInt_t k=0; k<THcShTrack::fNpmts; k++) {
-	Q[i][k] = 0.;
-	Q[k][i] = 0.;
-      }
-      Q[i][i] = 1.;
-    }
-
-  }
-  //  Q.Print();//wph
-  // Declare LU decomposition method for the correlation matrix Q.
-
-    TDecompLU lu(Q);
-  //  TDecompSVD lu(Q);
-  Double_t d1,d2;
-  lu.Det(d1,d2);
-  cout << "cond:" << lu.Condition() << endl;
-  cout << "det :" << d1*TMath::Power(2.,d2) << endl;
-  cout << "tol :" << lu.GetTol() << endl;
-
-  // Solve equation Q x au = qe for the 'unconstrained' calibration (gain)
-  // constants au.
-
-  au = lu.Solve(qe,ok);
-  cout << "au: ok=" << ok << endl;
-  //  au.Print();
-
-  // Find the sought 'constrained' calibration constants next.
-
-  Double_t t1 = fe0 - au * q0;         // temporary variable.
-  //  cout << "t1 =" << t1 << endl;
-
-  TVectorD Qiq0(THcShTrack::fNpmts);   // an intermittent result
-  Qiq0 = lu.Solve(q0,ok);
-  cout << "Qiq0: ok=" << ok << endl;
-  //  Qiq0.Print();
-
-  Double_t t2 = q0 * Qiq0;             // another temporary variable
-  //  cout << "t2 =" << t2 << endl;
-
-  ac = (t1/t2) *Qiq0 + au;             // the sought gain constants
-  //  cout << "ac:" << endl;
-  //  ac.Print();
-
-  // Assign the gain arrays.
-
-  for (UInt_t i=0; i<THcShTrack::fNpmts; i++) {
-    falphaU[i] = au[i];
-    falphaC[i] = ac[i];
-  }
-
 }
 
 //------------------------------------------------------------------------------
@@ -942,70 +739,53 @@ void THcShowerCalib::FillHEcal() {
 
   THcShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
 
-    if (ReadShRawTrack(trk, ientry)) {
-
-      //    trk.Print(cout);
-      //************wph*************
-      Double_t  xCalo= H_tr_x + H_tr_xp*D_CALO_FP ;  //could have done trk.GetX()
-      Double_t  yCalo= H_tr_y + H_tr_yp*D_CALO_FP ;
-      Double_t  xExit= H_tr_x + H_tr_xp*D_DPEXIT_FP ; //but not here
-      Double_t  yExit= H_tr_y + H_tr_yp*D_DPEXIT_FP ;
-
-      hCaloPos->Fill(yCalo,xCalo);
-      hExitPos->Fill(yExit,xExit);
-      
-      
-      //       Causes Seg Fault
-      //       for(UInt_t i=0; i<THcShTrack::fNpmts;i++)
-      //	 {
-      
-      for(UInt_t i=0; i< THcShTrack::fNrows; i++)
-	{
-  	 hAdc[i]->Fill(H_cal_1pr_apos_p[i]);
-	 hAdc[i+13]->Fill(H_cal_1pr_aneg_p[i]);
-	 hAdc[i+26]->Fill(H_cal_2ta_apos_p[i]);
-	 hAdc[i+39]->Fill(H_cal_2ta_aneg_p[i]);
-	 hAdc[i+52]->Fill(H_cal_3ta_apos_p[i]);
-	 hAdc[i+65]->Fill(H_cal_4ta_apos_p[i]);
+    GetShTrack(trk, iev);
+    cal_event &ev = fEvents[iev];
 
-	}
-      
-	 //	 }
+    //    trk.Print(cout);
+    //************wph*************
+    Double_t  xCalo= ev.x + ev.xp*D_CALO_FP ;  //could have done trk.GetX()
+    Double_t  yCalo= ev.y + ev.yp*D_CALO_FP ;
+    Double_t  xExit= ev.x + ev.xp*D_DPEXIT_FP ; //but not here
+    Double_t  yExit= ev.y + ev.yp*D_DPEXIT_FP ;
 
+    hCaloPos->Fill(yCalo,xCalo);
+    hExitPos->Fill(yExit,xExit);
 
-      //******************************
+    // (the raw pulse integrals hAdc are filled in ReadEvents())
 
+    //******************************
 
 
-      trk.SetEs(falphaC);        // use the 'constrained' calibration constants
-      Double_t P = trk.GetP();
-      Double_t delta = trk.GetDp();
-      Double_t Enorm = trk.Enorm();
 
-      //    cout << "CalcThreshods: nev=" << nev << "  Enorm=" << Enorm << endl;
-      hEcal->Fill(Enorm);
+    trk.SetEs(falphaC);        // use the 'constrained' calibration constants
+    Double_t P = trk.GetP();
+    Double_t delta = trk.GetDp();
+    Double_t Enorm = trk.Enorm();
 
-      hDPvsEcal->Fill(Enorm,delta,1.);
-      hCaloPosWt->Fill(yCalo,xCalo,Enorm);
-      hCaloPosNorm->Divide(hCaloPosWt,hCaloPos);
-      hETAvsEPR->Fill(trk.EPRnorm(), trk.ETAnorm());
-      yCalVsEp->Fill(Enorm, trk.GetY());
-      xCalVsEp->Fill(Enorm, trk.GetX());
+    //    cout << "CalcThreshods: nev=" << nev << "  Enorm=" << Enorm << endl;
+    hEcal->Fill(Enorm);
 
-      //Plots with uncalibrated E
-      trk.SetEs(falphaU); 
-      hCaloPosWtU->Fill(yCalo,xCalo,trk.Enorm());
-      hCaloPosNormU->Divide(hCaloPosWtU,hCaloPos);	
-      nev++;
+    hDPvsEcal->Fill(Enorm,delta,1.);
+    hCaloPosWt->Fill(yCalo,xCalo,Enorm);
+    hCaloPosNorm->Divide(hCaloPosWt,hCaloPos);
+    hETAvsEPR->Fill(trk.EPRnorm(), trk.ETAnorm());
+    yCalVsEp->Fill(Enorm, trk.GetY());
+    xCalVsEp->Fill(Enorm, trk.GetX());
 
-      //      output << Enorm*P/1000. << " " << P/1000. << " " << delta << " "
-      //     << trk.GetX() << " " << trk.GetY() << endl;
+    //Plots with uncalibrated E
+    trk.SetEs(falphaU); 
+    hCaloPosWtU->Fill(yCalo,xCalo,trk.Enorm());
+    hCaloPosNormU->Divide(hCaloPosWtU,hCaloPos);	
+    nev++;
 
-      //      evFile << Enorm << "\t" << nev <<endl;
+    //      output << Enorm*P/1000. << " " << P/1000. << " " << delta << " "
+    //     << trk.GetX() << " " << trk.GetY() << endl;
+
+    //      evFile << Enorm << "\t" << nev <<endl;
 
-    }
  
     if (nev > 200000) break;
   };
@@ -1029,19 +809,18 @@ void THcShowerCalib::FillHEcalNoCor() {
 
   THcShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
 
-    if (ReadShRawTrack(trk, ientry)) {
+    GetShTrack(trk, iev);
 
-      trk.SetEsNoCor(falphaC);        // use the 'constrained' calibration constants
-      Double_t P = trk.GetP();
-      Double_t delta = trk.GetDp();
-      Double_t Enorm = trk.Enorm();
+    trk.SetEsNoCor(falphaC);        // use the 'constrained' calibration constants
+    Double_t P = trk.GetP();
+    Double_t delta = trk.GetDp();
+    Double_t Enorm = trk.Enorm();
 
-      hEcalNoCor->Fill(Enorm);
+    hEcalNoCor->Fill(Enorm);
 
-      nev++;
-    }
+    nev++;
 
     if (nev > 200000) break;
   };
@@ -1059,13 +838,13 @@ void THcShowerCalib::SaveAlphas() {
   //
 
   ofstream output;
-  char* fname = Form("pcal.param.%s_%d_%d", fPrefix.c_str(),
+  char* fname = Form("pcal.param.%s_%d_%d", GetTag().c_str(),
 		     fNstart, fNstopRequested);
   cout << "SaveAlphas: fname=" << fname << endl;
 
   output.open(fname,ios::out);
 
-  output << "; Calibration constants for file " << fPrefix << ".root"
+  output << "; Calibration constants for file(s) " << fPrefix << ".root"
 	 << ", " << fNev << " events processed" << endl;
   output << endl;
   output <<";"<< "fDeltaMin  fDeltaMax" <<"\t"<< "fBetaMin fBetaMax" <<"\t"<< "fLoThr" <<"\t"<< "fHiThr"; 
@@ -1109,19 +888,17 @@ void THcShowerCalib::SaveAlphas() {
 
 void THcShowerCalib::FillCutBranch() {
   cout <<"Filling cut branches..."<<endl;
-  Int_t nev=0;
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) 
+  // (cut variables of the first 200001 entries, saved by ReadEvents())
+  for (UInt_t i=0; i<fCutVars.size(); i++) 
     {
-      fTree->GetEntry(ientry);
-      hCer->Fill(H_cer_npeSum);
-      hP->Fill(H_tr_p);
-      hDelta->Fill(H_tr_tg_dp);
-      hBeta->Fill(H_tr_beta);
-      hNclust->Fill(H_cal_nclust);
-      hNtrack->Fill(H_tr_n);
-            hClusTrk->Fill(H_cal_nclust,H_tr_n);  
-      nev++;
-      if (nev > 200000) break;
+      cal_cutvars &c = fCutVars[i];
+      hCer->Fill(c.cer);
+      hP->Fill(c.p);
+      hDelta->Fill(c.dp);
+      hBeta->Fill(c.beta);
+      hNclust->Fill(c.nclust);
+      hNtrack->Fill(c.ntrack);
+            hClusTrk->Fill(c.nclust,c.ntrack);  
     }
 }
 
@@ -11,23 +11,29 @@
 // A steering Root script for the HMS calorimeter calibration.
 //
 
-void hcal_calib(string Prefix, int nstop=-1, int nstart=0) {
+void hcal_calib(string Prefix, int nstop=-1, int nstart=0, int niter=0) {
 
   bool DRAW = 1;  //flag to draw extra plots
 
   // Initialize the analysis clock
   clock_t t = clock();
   
-  cout << "Calibrating file " << Prefix << ".root, events "
+  // Prefix may be a comma separated list of runs, e.g.
+  // "hms_replay_303,hms_replay_304": the runs are read in parallel and
+  // calibrated on together (the events nstart -- nstop of each run).
+
+  cout << "Calibrating file(s) " << Prefix << ".root, events "
        << nstart << " -- " << nstop << endl;
 
   THcShowerCalib theShowerCalib(Prefix, nstart, nstop);
+  string Tag = theShowerCalib.GetTag();   // for the output file names
 
  theShowerCalib.ReadThresholds();  // Read in threshold param-s and intial gains
  theShowerCalib.Init();            // Initialize constants and variables
  theShowerCalib.CalcThresholds();  // Thresholds on the uncalibrated Edep/P
  theShowerCalib.ComposeVMs();      // Compute vectors amd matrices for calib.
  theShowerCalib.SolveAlphas();     // Solve for the calibration constants
+ if (niter>0) theShowerCalib.Iterate(niter); // Re-window and re-solve
  theShowerCalib.SaveAlphas();      // Save the constants
  // theShowerCalib.SaveRawData();  // Save raw data into file for debug purposes
  theShowerCalib.FillHEcal();       // Fill histograms
@@ -93,7 +99,7 @@ void hcal_calib(string Prefix, int nstop=-1, int nstart=0) {
   theShowerCalib.hCaloPosNorm->Draw("COLZ");
  
  // Save canvas in a pdf format.
- Canvas->Print(Form("%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+ Canvas->Print(Form("%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
 
 // A bunch of diagnostic plots added Oct. 2019
 //wph
@@ -282,9 +288,9 @@ void hcal_calib(string Prefix, int nstop=-1, int nstart=0) {
  }
  
  // Save canvases
- Canvas2->Print(Form("PDFs/hits_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
- Canvas3->Print(Form("PDFs/cuts_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
- Canvas3->Print(Form("PDFs/pInt_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+ Canvas2->Print(Form("PDFs/hits_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
+ Canvas3->Print(Form("PDFs/cuts_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
+ Canvas3->Print(Form("PDFs/pInt_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
  }
 
  //  If you want to save the histograms in a root file 
@@ -73,6 +73,15 @@ Double_t phod_trefcut = 0.;            //**NOTE: Use this to set t_coin_trig_tdc
 Double_t pdc_trefcut  = 0.;
 Double_t padc_trefcut = 0.;            //**NOTE: Use this to set t_coin_trig_tdcrefcut in tcoin.param
 
+// Suggested ref. time parameters (see extract_ref_times(), written to param_files/*_reftime_cut_*_new.param)
+Double_t hhod_trefcut_new = 0.;
+Double_t hdc_trefcut_new  = 0.;
+Double_t hadc_trefcut_new = 0.;
+
+Double_t phod_trefcut_new = 0.;
+Double_t pdc_trefcut_new  = 0.;
+Double_t padc_trefcut_new = 0.;
+
 
 
 //=======================================================
@@ -84,7 +93,7 @@ Double_t padc_trefcut = 0.;            //**NOTE: Use this to set t_coin_trig_tdc
 //==========SET DETECTOR TIME WINDOW CUTS=================
 //========================================================
 
-//**NOTE** : Hodoscopes /Calorimeters are set from the histogram mean/sigma in the code. (They are ONLY initialized here)
+//**NOTE** : Hodoscopes /Calorimeters are set from the histogram peak in the code, see extract_time_windows(). (They are ONLY initialized here)
 
 //----------------------------
 //------ HMS HODOSCOPES ------
@@ -185,6 +194,37 @@ Double_t hcal_nSig = 40.;  //calorimeter
 Double_t phod_nSig = 40.;  // hodoscopes
 Double_t pcal_nSig = 40.;  // calorimeter
 
+//Cherenkovs
+Double_t hcer_nSig = 40.;  // HMS cherenkov
+Double_t pcer_nSig = 40.;  // SHMS heavy/noble gas cherenkov
+
+//---------------------------------------
+//----Automatic cut extraction (see extract_ref_times(), extract_time_windows())
+//----------------------------------------
+
+Int_t    peak_min_entries = 50;   // min. counts in the peak region to extract a channel window (else: median peak of its plane/side is used)
+Double_t edge_frac   = 0.05;      // ref. time / DC time distribution edges: fraction of the (3-bin summed) maximum
+Int_t    edge_margin = 2;         // number of bins added outside of the edges
+
+// Suggested time windows not derived from the hodo/cal (mean +/- nSig) logic
+// (the plain arrays above hold the existing cuts for these detectors)
+Double_t hCer_tWinMin_new[2] = {0.};
+Double_t hCer_tWinMax_new[2] = {0.};
+Double_t hDC_tWinMin_new[dc_PLANES] = {0.};
+Double_t hDC_tWinMax_new[dc_PLANES] = {0.};
+
+Double_t pPrsh_tWinMin_new[2][14] = {{0.}};
+Double_t pPrsh_tWinMax_new[2][14] = {{0.}};
+Double_t phgcer_tWinMin_new[4] = {0.};
+Double_t phgcer_tWinMax_new[4] = {0.};
+Double_t pngcer_tWinMin_new[4] = {0.};
+Double_t pngcer_tWinMax_new[4] = {0.};
+Double_t pDC_tWinMin_new[dc_PLANES] = {0.};
+Double_t pDC_tWinMax_new[dc_PLANES] = {0.};
+
+// Channels flagged during the extraction (printed and written to param_files/cut_flags_run<run>.txt)
+vector<TString> cut_flags;
+
 
 //----------------------------------
 //Coincidence Trigger Components: 
@@ -388,6 +428,14 @@ TLine *pT2_Line;      //shms trigger ref. time
 TLine *pDCREF_Line;  //shms DC ref. time
 TLine *pFADC_Line;    //flash ADC ref. time
 
+//suggested ref. time cuts
+TLine *hT1_Line_new;
+TLine *hDCREF_Line_new;
+TLine *hFADC_Line_new;
+TLine *pT2_Line_new;
+TLine *pDCREF_Line_new;
+TLine *pFADC_Line_new;
+
   
 //-----Detectors Time Window CUts Lines-----
 
@@ -520,86 +568,182 @@ TString n_ptrg4_r2;
 
 TString n_pEDTM;
 
+//========================================
+//Define Detector Groups (user selection)
+//========================================
+
+// Detector groups read / filled / drawn (set from the 'dets' argument of set_reftimes(), see set_detector_groups())
+// ref. times   : use_hodo (hT1, pT1, pT2), use_dc (DC REF), use_fadc (fADC REF)
+// time windows : use_trg, use_hodo, use_dc, use_cer, use_cal
+Bool_t use_trg  = true;
+Bool_t use_hodo = true;
+Bool_t use_dc   = true;
+Bool_t use_cer  = true;
+Bool_t use_cal  = true;
+Bool_t use_fadc = true;
+
 //========================================
 //Define Variables Associated with Leafs
 //========================================
 
 /*
-  NOTE: It is EXTREMELY IMPORTANT TO DECLARE VARIABLES whic
-  will be used in SetBranchAddress as STATIC to avoid any
-  weirdendness when the valriable is obtained during T-GetEntry()
-  
+  NOTE: It is EXTREMELY IMPORTANT that the variables which
+  will be used in SetBranchAddress stay at a fixed address (i.e., NOT on the
+  stack) to avoid any weirdendness when the valriable is obtained during T-GetEntry()
+
   In my experience, because I did NOT have these set to static,
   the HMS Calorimeter layer 1 (pr) Pos, for PMT indices [0] and [1]
-  was outputting ONLY zeros. 
+  was outputting ONLY zeros.
 
+  The leaf variables are members of reftimes_worker, which is always
+  allocated with new (one per thread): each thread reads its own
+  range of entries into its own buffers and fills its own copy of the histograms,
+  which are added to the (global) booked histograms at the end.
 */
 
-//HMS Leaf Variables
-static Double_t hhod_TdcTimeUnCorr[hod_PLANES][SIDES][16];
-static Double_t hhod_TdcAdcTimeDiff[hod_PLANES][SIDES][16];
-static Double_t hhod_AdcMult[hod_PLANES][SIDES][16];
-static Double_t hcer_TdcAdcTimeDiff[2];
-static Double_t hcer_AdcMult[2];
-static Double_t hcal_TdcAdcTimeDiff[cal_PLANES][SIDES][13];
-static Double_t hcal_AdcMult[cal_PLANES][SIDES][13];
-
-//HMS Ref. Time Varables                                                                                                                                           
-static Double_t hT1_ref;                                                                                                    
-static Double_t hDC_ref[4];                                                                                      
-static Double_t hFADC_ref;
-static Double_t hT1_tdcMult;
-static Double_t hDC_tdcMult[4];
-static Double_t hFADC_adcMult;
-
-//SHMS Leaf Variables
-static Double_t phod_TdcTimeUnCorr[hod_PLANES][SIDES][21];
-static Double_t phod_TdcAdcTimeDiff[hod_PLANES][SIDES][21];
-static Double_t phod_AdcMult[hod_PLANES][SIDES][21];
-static Double_t pcal_TdcAdcTimeDiff[1][224];
-static Double_t pcal_AdcMult[1][224];
-static Double_t pPrSh_TdcAdcTimeDiff[1][SIDES][14]; 
-static Double_t pPrSh_AdcMult[1][SIDES][14];
-static Double_t pcal_AdcTime[1][224];
-static Double_t pPrSh_AdcTime[1][SIDES][14]; 
-static Double_t phgcer_TdcAdcTimeDiff[4];
-static Double_t phgcer_AdcMult[4];
-static Double_t pngcer_TdcAdcTimeDiff[4];
-static Double_t pngcer_AdcMult[4];
-
-//SHMS Ref. Time Varables                                                                                                                                           
-static Double_t pT1_ref;
-static Double_t pT2_ref;                                                                                                    
-static Double_t pDC_ref[10];                                                                                      
-static Double_t pFADC_ref;
-static Double_t pT1_tdcMult;
-static Double_t pT2_tdcMult;
-static Double_t pDC_tdcMult[10];
-static Double_t pFADC_adcMult;
-
-//Drift Chamber rawTDC / Ndata / Multiplicity
-static Double_t hdc_rawTDC[dc_PLANES][1000];
-static Double_t pdc_rawTDC[dc_PLANES][1000];
-
-static Int_t hndata_rawTDC[dc_PLANES];
-static Int_t pndata_rawTDC[dc_PLANES];
-
-//TRG Detector Leaf Variables
-static Double_t ptrg1_r1;
-static Double_t ptrg1_r2;
-
-static Double_t ptrg2_r1;
-static Double_t ptrg2_r2;
-
-static Double_t ptrg3_r1;
-static Double_t ptrg3_r2;
-
-static Double_t ptrg4_r1;
-static Double_t ptrg4_r2;
-
-static Double_t pEDTM;
+struct reftimes_worker
+{
+  
+  TFile *data_file;
+  TTree *T;
+  Long64_t first_entry, last_entry;    //entry range [first, last) read by this worker
+
+  Bool_t set_refTimes;
+  Bool_t debug;
+  
+  //HMS Leaf Variables
+  Double_t hhod_TdcTimeUnCorr[hod_PLANES][SIDES][16];
+  Double_t hhod_TdcAdcTimeDiff[hod_PLANES][SIDES][16];
+  Double_t hhod_AdcMult[hod_PLANES][SIDES][16];
+  Double_t hcer_TdcAdcTimeDiff[2];
+  Double_t hcer_AdcMult[2];
+  Double_t hcal_TdcAdcTimeDiff[cal_PLANES][SIDES][13];
+  Double_t hcal_AdcMult[cal_PLANES][SIDES][13];
+
+  //HMS Ref. Time Varables
+  Double_t hT1_ref;
+  Double_t hDC_ref[4];
+  Double_t hFADC_ref;
+  Double_t hT1_tdcMult;
+  Double_t hDC_tdcMult[4];
+  Double_t hFADC_adcMult;
+
+  //SHMS Leaf Variables
+  Double_t phod_TdcTimeUnCorr[hod_PLANES][SIDES][21];
+  Double_t phod_TdcAdcTimeDiff[hod_PLANES][SIDES][21];
+  Double_t phod_AdcMult[hod_PLANES][SIDES][21];
+  Double_t pcal_TdcAdcTimeDiff[1][224];
+  Double_t pcal_AdcMult[1][224];
+  Double_t pPrSh_TdcAdcTimeDiff[1][SIDES][14]; 
+  Double_t pPrSh_AdcMult[1][SIDES][14];
+  Double_t pcal_AdcTime[1][224];
+  Double_t pPrSh_AdcTime[1][SIDES][14]; 
+  Double_t phgcer_TdcAdcTimeDiff[4];
+  Double_t phgcer_AdcMult[4];
+  Double_t pngcer_TdcAdcTimeDiff[4];
+  Double_t pngcer_AdcMult[4];
+
+  //SHMS Ref. Time Varables
+  Double_t pT1_ref;
+  Double_t pT2_ref;
+  Double_t pDC_ref[10];
+  Double_t pFADC_ref;
+  Double_t pT1_tdcMult;
+  Double_t pT2_tdcMult;
+  Double_t pDC_tdcMult[10];
+  Double_t pFADC_adcMult;
+
+  //Drift Chamber rawTDC / Ndata / Multiplicity
+  Double_t hdc_rawTDC[dc_PLANES][1000];
+  Double_t pdc_rawTDC[dc_PLANES][1000];
+
+  Int_t hndata_rawTDC[dc_PLANES];
+  Int_t pndata_rawTDC[dc_PLANES];
+
+  //TRG Detector Leaf Variables
+  Double_t ptrg1_r1;
+  Double_t ptrg1_r2;
+
+  Double_t ptrg2_r1;
+  Double_t ptrg2_r2;
+
+  Double_t ptrg3_r1;
+  Double_t ptrg3_r2;
+
+  Double_t ptrg4_r1;
+  Double_t ptrg4_r2;
+
+  Double_t pEDTM;
+
+  //Histograms filled by this worker (detached copies of the histograms of the same name, see CopyHistos())
+  TH1F *H_hodo_Tref;
+  TH1F *H_DC_Tref[4];
+  TH1F *H_FADC_Tref;
+  TH1F *H_hodo_Tref_CUT;
+  TH1F *H_DC_Tref_CUT[4];
+  TH1F *H_FADC_Tref_CUT;
+
+  TH1F *P_hodo_Tref1;
+  TH1F *P_hodo_Tref2;
+  TH1F *P_DC_Tref[10];
+  TH1F *P_FADC_Tref;
+  TH1F *P_hodo_Tref1_CUT;
+  TH1F *P_hodo_Tref2_CUT;
+  TH1F *P_DC_Tref_CUT[10];
+  TH1F *P_FADC_Tref_CUT;
+
+  TH1F *H_hod_TdcTimeUnCorr[hod_PLANES][SIDES][16];
+  TH1F *H_hod_TdcAdcTimeDiff[hod_PLANES][SIDES][16];
+  TH1F *H_cal_TdcAdcTimeDiff[cal_PLANES][SIDES][13];
+  TH1F *H_dc_rawTDC[dc_PLANES];
+  TH1F *H_cer_TdcAdcTimeDiff[2];
+  TH1F *H_hod_TdcAdcTimeDiff_CUT[hod_PLANES][SIDES][16];
+  TH1F *H_cal_TdcAdcTimeDiff_CUT[cal_PLANES][SIDES][13];
+  TH1F *H_dc_rawTDC_CUT[dc_PLANES];
+  TH1F *H_cer_TdcAdcTimeDiff_CUT[2];
+
+  TH1F *P_hod_TdcTimeUnCorr[hod_PLANES][SIDES][21];
+  TH1F *P_hod_TdcAdcTimeDiff[hod_PLANES][SIDES][21];
+  TH1F *P_cal_TdcAdcTimeDiff[224];
+  TH1F *P_prSh_TdcAdcTimeDiff[SIDES][14];
+  TH1F *P_cal_AdcTime[224];
+  TH1F *P_prSh_AdcTime[SIDES][14];
+  TH1F *P_dc_rawTDC[dc_PLANES];
+  TH1F *P_hgcer_TdcAdcTimeDiff[4];
+  TH1F *P_ngcer_TdcAdcTimeDiff[4];
+  TH1F *P_hod_TdcAdcTimeDiff_CUT[hod_PLANES][SIDES][21];
+  TH1F *P_cal_TdcAdcTimeDiff_CUT[224];  
+  TH1F *P_prSh_TdcAdcTimeDiff_CUT[SIDES][14];
+  TH1F *P_dc_rawTDC_CUT[dc_PLANES];
+  TH1F *P_hgcer_TdcAdcTimeDiff_CUT[4];
+  TH1F *P_ngcer_TdcAdcTimeDiff_CUT[4];
+
+  TH1F *pTrig1_ROC1_rawTdcTime;
+  TH1F *pTrig1_ROC2_rawTdcTime;
+  TH1F *pTrig2_ROC1_rawTdcTime;
+  TH1F *pTrig2_ROC2_rawTdcTime;
+  TH1F *pTrig3_ROC1_rawTdcTime;
+  TH1F *pTrig3_ROC2_rawTdcTime;
+  TH1F *pTrig4_ROC1_rawTdcTime;
+  TH1F *pTrig4_ROC2_rawTdcTime;
+  TH1F *pEDTM_rawTdcTime;
+
+  //(booked histogram, worker copy) pairs, used to merge the copies back
+  vector<pair<TH1F*, TH1F*> > histos;
+
+  reftimes_worker(TString filename, Long64_t first, Long64_t last, Bool_t refTimes, Bool_t dbg);
+  ~reftimes_worker();
+
+  TH1F *Copy(TH1F *h);
+  void CopyHistos();
+  void Use(TString leaf, void *addr);
+  void SetBranches(TString daq_mode);
+  void Loop();
+  void Merge();
+  
+};
 
 //=========================================================
 
 
-#endif 
+#endif
@@ -19,6 +19,8 @@ fi
 daq_mode="coin"
 set_refTimes=0
 debug=1
+dets="all"     # detector groups to check, e.g. "dc" or "hodo,cal" (see scripts/set_reftimes.C)
+nthreads=0     # event loop threads (0: one per core)
   
 # Which analysis file type are we doing? 
 ana_type="timewin"
@@ -30,7 +32,7 @@ replay_script="SCRIPTS/COIN/PRODUCTION/replay_cafe.C"
 analysis_script="scripts/set_reftimes.C"
 
 runHcana="./hcana -q \"${replay_script}(${runNum}, ${evtNum}, \\\"${ana_type}\\\")\""
-runAna="root -l -q -b \"${analysis_script}(\\\"${filename}\\\", ${runNum}, \\\"${daq_mode}\\\", ${set_refTimes}, ${debug})\""   
+runAna="root -l -q -b \"${analysis_script}(\\\"${filename}\\\", ${runNum}, \\\"${daq_mode}\\\", ${set_refTimes}, ${debug}, \\\"${dets}\\\", ${nthreads})\""   
 
 # change to top direcotry and run analyzer to produce specified ROOTfile
 if [ "${replay}" == "replay" ]; then
@@ -53,7 +53,3 @@ void THcPShHit::Print(ostream & ostrm) {
 
   ostrm << ADC << " " << Edep << " " << BlkNumber << endl;
 };
-
-//------------------------------------------------------------------------------
-
-struct pmt_hit {Double_t signal; UInt_t channel;};
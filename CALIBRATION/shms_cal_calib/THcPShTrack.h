@@ -27,6 +27,7 @@ class THcPShTrack {
   Double_t Yp;  // slope
 
   THcPShHitList Hits;
+  THcPShHitList Spare;   // hit objects of previous events, for reuse
 
  public:
 
@@ -104,6 +105,9 @@ void THcPShTrack::Reset(Double_t p, Double_t dp,
   Xp = xp;
   Y = y;
   Yp =yp;
+
+  // Keep the hit objects for the next event (see AddHit()).
+  Spare.insert(Spare.end(), Hits.begin(), Hits.end());
   Hits.clear();
 };
 
@@ -113,7 +117,16 @@ void THcPShTrack::AddHit(Double_t adc, Double_t edep, UInt_t blk_number) {
 
   // Add a hit to the hit list.
 
-  THcPShHit* hit = new THcPShHit(adc, blk_number);
+  THcPShHit* hit;
+  if (Spare.empty()) {
+    hit = new THcPShHit(adc, blk_number);
+  }
+  else {
+    hit = Spare.back();
+    Spare.pop_back();
+    hit->SetADC(adc);
+    hit->SetBlkNumber(blk_number);
+  }
   hit->SetEdep(edep);
   Hits.push_back(hit);
 };
@@ -121,9 +134,7 @@ void THcPShTrack::AddHit(Double_t adc, Double_t edep, UInt_t blk_number) {
 //------------------------------------------------------------------------------
 
 THcPShHit* THcPShTrack::GetHit(UInt_t k) {
-  THcPShHitIt it = Hits.begin();
-  for (UInt_t i=0; i<k; i++) it++;
-  return *it;
+  return Hits[k];
 }
 
 //------------------------------------------------------------------------------
@@ -148,6 +159,10 @@ THcPShTrack::~THcPShTrack() {
     delete *i;
     *i = 0;
   }
+  for (THcPShHitIt i = Spare.begin(); i != Spare.end(); ++i) {
+    delete *i;
+    *i = 0;
+  }
 };
 
 //------------------------------------------------------------------------------
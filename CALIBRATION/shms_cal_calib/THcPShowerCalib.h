@@ -2,11 +2,9 @@
 #define ROOT_THcPShowerCalib
 
 #include "THcPShTrack.h"
+#include "../cal_calib/THcCalCalib.h"
 #include "TH1F.h"
 #include "TH2F.h"
-#include "TVectorD.h"
-#include "TMatrixD.h"
-#include "TDecompLU.h"
 #include "TMath.h"
 #include <iostream>
 #include <fstream>
@@ -16,12 +14,15 @@
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TDirectory.h"
 
 #include "TF1.h"
 
 #include <time.h>
 
 #include <vector>
+#include <algorithm>
+#include <thread>
 
 #include <string>
 
@@ -41,11 +42,27 @@ using namespace std;
 
 bool CollCut(double xptar , double ytar, double yptar, double delta);
 
+struct psh_hit {            // saved hits of the events (see ReadEvents())
+  Double_t adc;
+  UInt_t blk;
+};
+
+//
+// SHMS calorimeter descriptor for the calibration core (THcCalCalib.h).
+//
+
+struct THcPShGeom {
+  static constexpr UInt_t fNpmts = THcPShTrack::fNpmts;
+  static constexpr UInt_t fNevThr = 2000000;   // as in CalcThresholds()
+  static constexpr bool fPosEnorm = true;
+  typedef psh_hit Hit;
+};
+
 //
 // SHMS Calorimeter calibration class.
 //
 
-class THcPShowerCalib {
+class THcPShowerCalib : public THcCalCalib<THcPShGeom> {
 
  public:
 
@@ -55,25 +72,20 @@ class THcPShowerCalib {
 
   void ReadThresholds();
   void Init();
+  void OpenTree();
   bool ReadShRawTrack(THcPShTrack &trk, UInt_t ientry);
+  void ReadEvents();
+  void GetShTrack(THcPShTrack &trk, UInt_t iev);
   void CalcThresholds();
-  void ComposeVMs();
-  void SolveAlphas();
+  void PrintHitCounts();
   void FillHEcal();
   void SaveAlphas();
   void SaveRawData();
   void fillHits();
   void howLong(Double_t goal);
   void fillCutBranch();
-  Double_t GetDeltaMin(){return fDeltaMin;};  
-  Double_t GetDeltaMax(){return fDeltaMax;};  
-  Double_t GetBetaMin(){return fBetaMin;};  
-  Double_t GetBetaMax(){return fBetaMax;};  
   Double_t GetCerMin(){return fNGCerMin;};  
-  Double_t GetRatio(){return (Double_t)fNev/(fNstop-fNstart);};  
 
-  TH1F* hEunc;
-  TH1F* hEuncSel;
   TH1F* hEcal;
   TH2F* hDPvsEcal;
   TH2F* hESHvsEPR;
@@ -103,33 +115,15 @@ class THcPShowerCalib {
   //gains
   TH2F*  hpra;
   TH2F*  hsha;
-  TH2F*  pmtList;
-  TH1F **hAdc;
   TH2F* yCalVsEp;
   TH2F* xCalVsEp;
 
  private:
 
-  string fPrefix;
-  Double_t fLoThr;     // Low and high thresholds on the normalized uncalibrated
-  Double_t fHiThr;     // energy deposition.
-  UInt_t fNev;         // Number of processed events.
+  THcCalCalib<THcPShGeom>* NewReader(string run);
 
-  Double_t fDeltaMin, fDeltaMax;   // Delta range, %.
-  Double_t fBetaMin, fBetaMax;     // Beta range
   Double_t fHGCerMin;              // Threshold heavy gas Cerenkov signal, p.e.
   Double_t fNGCerMin;              // Threshold noble gas Cerenkov signal, p.e.
-  UInt_t fMinHitCount;             // Min. number of hits/chan. for calibration
-  Double_t fEuncLoLo, fEuncHiHi;   // Range of uncalibrated Edep histogram
-  UInt_t fEuncNBin;                // Binning of uncalibrated Edep histogram
-  Double_t fEuncGFitLo,fEuncGFitHi;// Gaussian fit range of uncalib. Edep histo.
-  Double_t sigmaRange;             // range for events to use for calib (e.g +/- 3*sigma)
-
-  TTree* fTree;
-  UInt_t fNentries;
-  UInt_t fNstart;
-  UInt_t fNstop;
-  Int_t  fNstopRequested;
 
   // Declaration of leaves types
 
@@ -190,19 +184,6 @@ class THcPShowerCalib {
   TBranch* b_P_cal_fly_nclust;
   TBranch* b_P_cal_fly_ntracks;
 
-  // Quantities for calculations of the calibration constants.
-
-  Double_t fe0;
-  Double_t fqe[THcPShTrack::fNpmts];
-  Double_t fq0[THcPShTrack::fNpmts];
-  Double_t fQ[THcPShTrack::fNpmts][THcPShTrack::fNpmts];
-  Double_t falphaU[THcPShTrack::fNpmts];   // 'unconstrained' calib. constants
-  Double_t falphaC[THcPShTrack::fNpmts];   // the sought calibration constants
-  Double_t falpha0[THcPShTrack::fNpmts];   // initial gains
-  Double_t falpha1[THcPShTrack::fNpmts];   // unit gains
-
-  UInt_t fHitCount[THcPShTrack::fNpmts];
-
 };
 
 //------------------------------------------------------------------------------
@@ -211,12 +192,8 @@ THcPShowerCalib::THcPShowerCalib() {};
 
 //------------------------------------------------------------------------------
 
-THcPShowerCalib::THcPShowerCalib(string Prefix, int nstart, int nstop) {
-  fPrefix = Prefix;
-  fNstart = nstart;
-  //  fNstop = nstop;  defined in Init
-  fNstopRequested = nstop;
-};
+THcPShowerCalib::THcPShowerCalib(string Prefix, int nstart, int nstop) :
+  THcCalCalib<THcPShGeom>(Prefix, nstart, nstop) {};
 
 //------------------------------------------------------------------------------
 
@@ -237,13 +214,10 @@ void THcPShowerCalib::SaveRawData() {
 
   THcPShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
-
-    if (ReadShRawTrack(trk, ientry)) {
-      trk.SetEs(falphaC);
-      trk.Print(fout);
-    }
-
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
+    GetShTrack(trk, iev);
+    trk.SetEs(falphaC);
+    trk.Print(fout);
   }
 
   fout.close();
@@ -380,56 +354,16 @@ void THcPShowerCalib::ReadThresholds() {
 
 void THcPShowerCalib::Init() {
 
-  //Reset ROOT and connect tree file.
+  //Reset ROOT and connect tree file (or the files of several runs, which
+  //are read in parallel by ReadRuns()).
 
   gROOT->Reset();
 
-  char* fname = Form("ROOTfiles/%s.root",fPrefix.c_str());
-  cout << "THcPShowerCalib::Init: Root file name = " << fname << endl;
-
-  TFile *f = new TFile(fname);
-  f->GetObject("T",fTree);
-
-  fNentries = fTree->GetEntries();
-  cout << "THcPShowerCalib::Init: fNentries= " << fNentries << endl;
-
-  fNstopRequested<0 ? fNstop = fNentries :
-                      fNstop = TMath::Min(unsigned(fNstopRequested), fNentries);
-  cout << "                       fNstop   = " << fNstop << endl;
-
-  // Set branch addresses.
-
-  fTree->SetBranchAddress("P.cal.pr.goodPosAdcPulseInt", P_pr_apos_p,
-			  &b_P_pr_apos_p);
-  fTree->SetBranchAddress("P.cal.pr.goodNegAdcPulseInt", P_pr_aneg_p, 
-			  &b_P_pr_aneg_p);
-  fTree->SetBranchAddress("P.cal.fly.goodAdcPulseInt",  P_sh_a_p,
-			  &b_P_sh_a_p);
-
-  fTree->SetBranchAddress("P.dc.ntrack", &P_tr_n,&b_P_tr_n);
-  //  fTree->SetBranchAddress("P.dc.InsideDipoleExit", &P_dc_insideDipoleExit,&b_P_dc_insideDipoleExit);
-  fTree->SetBranchAddress("P.dc.x_fp", &P_tr_x,&b_P_tr_x);
-  fTree->SetBranchAddress("P.dc.y_fp", &P_tr_y,&b_P_tr_y);
-  fTree->SetBranchAddress("P.dc.xp_fp",&P_tr_xp,&b_P_tr_xp);
-  fTree->SetBranchAddress("P.dc.yp_fp",&P_tr_yp,&b_P_tr_yp);
-  fTree->SetBranchAddress("P.gtr.p", &P_tr_p,&b_P_tr_p);
-
-  fTree->SetBranchAddress("P.gtr.dp", &P_tr_tg_dp,&b_P_tr_tg_dp);
-  fTree->SetBranchAddress("P.gtr.ph", &P_tr_tg_ph,&b_P_tr_tg_ph);
-  fTree->SetBranchAddress("P.gtr.th", &P_tr_tg_th,&b_P_tr_tg_th);
-  fTree->SetBranchAddress("P.gtr.y",  &P_tr_tg_y, &b_P_tr_tg_y);
- 
-  fTree->SetBranchAddress("P.hgcer.npeSum", &P_hgcer_npeSum,&b_P_hgcer_npeSum);
-  fTree->SetBranchAddress("P.ngcer.npeSum", &P_ngcer_npeSum,&b_P_ngcer_npeSum);
-
-  fTree->SetBranchAddress("P.hod.beta", &P_tr_beta,&b_P_tr_beta);
-
-  fTree->SetBranchAddress("P.cal.nclust", &P_cal_nclust,&b_P_cal_nclust);
-  fTree->SetBranchAddress("P.cal.ntracks", &P_cal_ntracks,&b_P_cal_ntracks);
-  fTree->SetBranchAddress("P.cal.fly.nclust", &P_cal_fly_nclust,
-			  &b_P_cal_fly_nclust);
-  fTree->SetBranchAddress("P.cal.fly.ntracks", &P_cal_fly_ntracks,
-			  &b_P_cal_fly_ntracks);
+  if (fRuns.size() == 1)
+    OpenTree();
+  else
+    cout << "THcPShowerCalib::Init: " << fRuns.size() << " runs, entries "
+	 << fNstart << " -- " << fNstopRequested << " of each" << endl;
 
   // Histogram declarations.
 
@@ -476,30 +410,72 @@ void THcPShowerCalib::Init() {
   for(UInt_t i=0; i<THcPShTrack::fNpmts; i++){hAdc[i]=new TH1F(Form("hADC%d",i),"pulseInts",25,0.1,250);}
 
 
-  // Initialize cumulative quantities.
-  
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) fHitCount[i] = 0;
+  // Initialize cumulative quantities and gains.
 
-  fe0 = 0.;
+  InitVMs();
 
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-    fqe[i] = 0.;
-    fq0[i] = 0.;
-    falphaU[i] = 0.;
-    falphaC[i] = 0.;
-    for (UInt_t j=0; j<THcPShTrack::fNpmts; j++) {
-      fQ[i][j] = 0.;
-    }
-  }
+  // Single pass over the tree.
 
-  for (UInt_t ipmt=0; ipmt<THcPShTrack::fNpmts; ipmt++) {
-    falpha1[ipmt] = 1.;
-  }
+  ReadEvents();
 
 };
 
 //------------------------------------------------------------------------------
 
+void THcPShowerCalib::OpenTree() {
+
+  // Connect the tree file of the run fPrefix, and set branch addresses.
+
+  char* fname = Form("ROOTfiles/%s.root",fPrefix.c_str());
+  cout << "THcPShowerCalib::Init: Root file name = " << fname << endl;
+
+  fFile = new TFile(fname);
+  fFile->GetObject("T",fTree);
+
+  fNentries = fTree->GetEntries();
+  cout << "THcPShowerCalib::Init: fNentries= " << fNentries << endl;
+
+  fNstopRequested<0 ? fNstop = fNentries :
+                      fNstop = TMath::Min(unsigned(fNstopRequested), fNentries);
+  cout << "                       fNstop   = " << fNstop << endl;
+
+  // Set branch addresses.
+
+  fTree->SetBranchAddress("P.cal.pr.goodPosAdcPulseInt", P_pr_apos_p,
+			  &b_P_pr_apos_p);
+  fTree->SetBranchAddress("P.cal.pr.goodNegAdcPulseInt", P_pr_aneg_p, 
+			  &b_P_pr_aneg_p);
+  fTree->SetBranchAddress("P.cal.fly.goodAdcPulseInt",  P_sh_a_p,
+			  &b_P_sh_a_p);
+
+  fTree->SetBranchAddress("P.dc.ntrack", &P_tr_n,&b_P_tr_n);
+  //  fTree->SetBranchAddress("P.dc.InsideDipoleExit", &P_dc_insideDipoleExit,&b_P_dc_insideDipoleExit);
+  fTree->SetBranchAddress("P.dc.x_fp", &P_tr_x,&b_P_tr_x);
+  fTree->SetBranchAddress("P.dc.y_fp", &P_tr_y,&b_P_tr_y);
+  fTree->SetBranchAddress("P.dc.xp_fp",&P_tr_xp,&b_P_tr_xp);
+  fTree->SetBranchAddress("P.dc.yp_fp",&P_tr_yp,&b_P_tr_yp);
+  fTree->SetBranchAddress("P.gtr.p", &P_tr_p,&b_P_tr_p);
+
+  fTree->SetBranchAddress("P.gtr.dp", &P_tr_tg_dp,&b_P_tr_tg_dp);
+  fTree->SetBranchAddress("P.gtr.ph", &P_tr_tg_ph,&b_P_tr_tg_ph);
+  fTree->SetBranchAddress("P.gtr.th", &P_tr_tg_th,&b_P_tr_tg_th);
+  fTree->SetBranchAddress("P.gtr.y",  &P_tr_tg_y, &b_P_tr_tg_y);
+ 
+  fTree->SetBranchAddress("P.hgcer.npeSum", &P_hgcer_npeSum,&b_P_hgcer_npeSum);
+  fTree->SetBranchAddress("P.ngcer.npeSum", &P_ngcer_npeSum,&b_P_ngcer_npeSum);
+
+  fTree->SetBranchAddress("P.hod.beta", &P_tr_beta,&b_P_tr_beta);
+
+  fTree->SetBranchAddress("P.cal.nclust", &P_cal_nclust,&b_P_cal_nclust);
+  fTree->SetBranchAddress("P.cal.ntracks", &P_cal_ntracks,&b_P_cal_ntracks);
+  fTree->SetBranchAddress("P.cal.fly.nclust", &P_cal_fly_nclust,
+			  &b_P_cal_fly_nclust);
+  fTree->SetBranchAddress("P.cal.fly.ntracks", &P_cal_fly_ntracks,
+			  &b_P_cal_fly_ntracks);
+}
+
+//------------------------------------------------------------------------------
+
 void THcPShowerCalib::CalcThresholds() {
 
   // Calculate +/-3 RMS thresholds on the uncalibrated total energy
@@ -516,82 +492,43 @@ void THcPShowerCalib::CalcThresholds() {
   Int_t nev = 0;
   THcPShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
-
-    if ( ReadShRawTrack(trk, ientry)) {
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
 
-      //************wph*************
-      Double_t  xCalo= P_tr_x + P_tr_xp*D_CALO_FP ;  //could have done trk.GetX()
-      Double_t  yCalo= P_tr_y + P_tr_yp*D_CALO_FP ;
-      Double_t  xExit= P_tr_x + P_tr_xp*D_EXIT_FP ; //but not here
-      Double_t  yExit= P_tr_y + P_tr_yp*D_EXIT_FP ;
-
-      hCaloPos->Fill(yCalo,xCalo);
-      hExitPos->Fill(yExit,xExit);
-
-      for(UInt_t i=0; i< THcPShTrack::fNrows_pr; i++)
-	{
-	  hAdc[i]->Fill(P_pr_apos_p[i]);
-	  hAdc[i+THcPShTrack::fNrows_pr]->Fill(P_pr_aneg_p[i]);
-	}
+    GetShTrack(trk, iev);
+    cal_event &ev = fEvents[iev];
 
-      for(UInt_t i= 0; i< THcPShTrack::fNpmts - 2*THcPShTrack::fNrows_pr; i++)
-	{
-	  hAdc[i]->Fill(P_sh_a_p[i]);
-	}
+    //************wph*************
+    Double_t  xCalo= ev.x + ev.xp*D_CALO_FP ;  //could have done trk.GetX()
+    Double_t  yCalo= ev.y + ev.yp*D_CALO_FP ;
+    Double_t  xExit= ev.x + ev.xp*D_EXIT_FP ; //but not here
+    Double_t  yExit= ev.y + ev.yp*D_EXIT_FP ;
 
+    hCaloPos->Fill(yCalo,xCalo);
+    hExitPos->Fill(yExit,xExit);
 
-	trk.SetEs(falpha0);             //Use initial gain constants here.
-	Double_t Enorm = trk.Enorm();
+    // (the raw pulse integrals hAdc are filled in ReadEvents())
 
+    trk.SetEs(falpha0);             //Use initial gain constants here.
+    Double_t Enorm = trk.Enorm();
 
-	////
-	if (Enorm > 0.) {
-	  hEunc->Fill(Enorm);
-	  hETOTvsEPRunc->Fill(trk.EPRnorm(),Enorm);          ////
-	  hESHvsEPRunc->Fill(trk.EPRnorm(),trk.ESHnorm());   ////
-	  hEPRunc->Fill(trk.EPRnorm());                      ////
-	  nev++;
-	}
+    ////
+    if (Enorm > 0.) {
+      hEunc->Fill(Enorm);
+      hETOTvsEPRunc->Fill(trk.EPRnorm(),Enorm);          ////
+      hESHvsEPRunc->Fill(trk.EPRnorm(),trk.ESHnorm());   ////
+      hEPRunc->Fill(trk.EPRnorm());                      ////
+      nev++;
+    }
 
     //    if (nev%100000 == 0)
     //      cout << "CalcThreshods: nev=" << nev << "  Enorm=" << Enorm << endl;
-    }
 
     if (nev > 2000000) break;
   };
 
-  //Find max bin (peak) and fit in range
-  //specified in input.dat
-  Double_t maxBin= hEunc->GetMaximumBin();
-  Double_t maxValue= hEunc->GetBinCenter(maxBin);
-  fEuncGFitLo=fEuncGFitLo+maxValue;
-  fEuncGFitHi=fEuncGFitHi+maxValue;
-  hEunc->Fit("gaus","","",fEuncGFitLo, fEuncGFitHi);
-  hEunc->GetFunction("gaus")->SetLineColor(2);
-  hEunc->GetFunction("gaus")->SetLineWidth(1);
-  hEunc->GetFunction("gaus")->SetLineStyle(1);
-  TF1 *fit = hEunc->GetFunction("gaus");
-  Double_t gmean  = fit->GetParameter(1);
-  Double_t gsigma = fit->GetParameter(2);
-  fLoThr = gmean - gsigma*sigmaRange;
-  fHiThr = gmean + gsigma*sigmaRange;
-  cout << "CalcThreshods: fLoThr=" << fLoThr << "  fHiThr=" << fHiThr 
-       << "  nev=" << nev << endl;
-
-  Int_t nbins = hEunc->GetNbinsX();
-  Int_t nlo = hEunc->FindBin(fLoThr);
-  Int_t nhi = hEunc->FindBin(fHiThr);
-
-  cout << "CalcThresholds: nlo=" << nlo << "  nhi=" << nhi 
-       << "  nbins=" << nbins << endl;
-
-  // Histogram of selected within the thresholds events.
-  
-  hEuncSel = (TH1F*)hEunc->Clone("hEuncSel");
-  
-  for (Int_t i=0; i<nlo; i++) hEuncSel->SetBinContent(i, 0.);
-  for (Int_t i=nhi; i<nbins+1; i++) hEuncSel->SetBinContent(i, 0.);
+  // Fit the peak (range specified in input.dat), set the thresholds.
+
+  FitThresholds(nev);
 
 };
 
@@ -687,161 +624,118 @@ bool THcPShowerCalib::ReadShRawTrack(THcPShTrack &trk, UInt_t ientry) {
 
 //------------------------------------------------------------------------------
 
-void THcPShowerCalib::ComposeVMs() {
+void THcPShowerCalib::ReadEvents() {
 
   //
-  // Fill in vectors and matrixes for the gain constant calculations.
+  // Read the tree ONCE: save the selected shower track events (track
+  // parameters and hits, see ReadShRawTrack()) in fEvents/fHits, and the cut
+  // variables of the first entries in fCutVars. All the calibration stages
+  // loop over these arrays instead of re-reading the tree.
   //
 
-  fNev = 0;
-  THcPShTrack trk;
-
-  // Loop over the shower track events in the ntuples.
+  if (fRuns.size() > 1) {
+    ReadRuns();
+    return;
+  }
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
+  fEvents.clear();
+  fHits.clear();
+  fCutVars.clear();
+  ClearPmtEvents();
 
-    if (ReadShRawTrack(trk, ientry)) {
+  THcPShTrack trk;
+  pmt_hit pmt_hit_list[THcPShTrack::fNpmts];   // PMT hits of the track
 
-      // Set energy depositions with default gains.
-      // Calculate normalized to the track momentum total energy deposition,
-      // check it against the thresholds.
+  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
 
-      trk.SetEs(falpha0);
-      Double_t Enorm = trk.Enorm();
-      if (Enorm>fLoThr && Enorm<fHiThr) {
+    bool good = ReadShRawTrack(trk, ientry);   // reads in the entry
 
-	trk.SetEs(falpha1);   // Set energies with unit gains for now.
-	// trk.Print(cout);
+    if (fCutVars.size() <= 200000)
+      fCutVars.push_back( cal_cutvars{P_ngcer_npeSum, P_tr_p, P_tr_tg_dp,
+	    P_tr_beta, P_cal_nclust, P_tr_n} );
 
-	fe0 += trk.GetP();    // Accumulate track momenta.
+    if (!good) continue;
 
-	vector<pmt_hit> pmt_hit_list;     // Container to save PMT hits
+    // Raw pulse integrals of the selected events (for CalcThresholds()).
 
-	// Loop over hits.
+    trk.SetEs(falpha0);
 
-	for (UInt_t i=0; i<trk.GetNhits(); i++) {
+    if (DiagEvent(trk.Enorm())) {
 
-	  THcPShHit* hit = trk.GetHit(i);
-	  // hit->Print(cout);
+      for(UInt_t i=0; i< THcPShTrack::fNrows_pr; i++)
+	{
+	  hAdc[i]->Fill(P_pr_apos_p[i]);
+	  hAdc[i+THcPShTrack::fNrows_pr]->Fill(P_pr_aneg_p[i]);
+	}
 
-	  UInt_t nb = hit->GetBlkNumber();
+      for(UInt_t i= 0; i< THcPShTrack::fNpmts - 2*THcPShTrack::fNrows_pr; i++)
+	{
+	  hAdc[i]->Fill(P_sh_a_p[i]);
+	}
+    }
 
-	  // Fill the qe and q0 vectors.
+    fEvents.push_back( cal_event{P_tr_p, P_tr_tg_dp, P_tr_x, P_tr_xp,
+	  P_tr_y, P_tr_yp, (UInt_t)fHits.size(), trk.GetNhits()} );
 
-	  fqe[nb-1] += hit->GetEdep() * trk.GetP();
-	  fq0[nb-1] += hit->GetEdep();
+    for (UInt_t i=0; i<trk.GetNhits(); i++) {
+      THcPShHit* hit = trk.GetHit(i);
+      fHits.push_back( psh_hit{hit->GetADC(), hit->GetBlkNumber()} );
+    }
 
-	  // Save the PMT hit.
+    // PMT signals with unit gains, for the calibration core.
 
-	  pmt_hit_list.push_back( pmt_hit{hit->GetEdep(), nb} );
+    trk.SetEs(falpha1);
 
-	  fHitCount[nb-1]++;   //Accrue the hit counter.
+    for (UInt_t i=0; i<trk.GetNhits(); i++) {
+      THcPShHit* hit = trk.GetHit(i);
+      pmt_hit_list[i] = pmt_hit{hit->GetEdep(), hit->GetBlkNumber()};
+    }
 
-	}      //over hits
+    AddPmtEvent(P_tr_p, pmt_hit_list, trk.GetNhits());
 
-	// Fill in the correlation matrix Q by retrieving the PMT hits.
+  }
 
-	for (vector<pmt_hit>::iterator i=pmt_hit_list.begin();
-	     i < pmt_hit_list.end(); i++) {
+  fNread = fNstop - fNstart;
 
-	  UInt_t ic = (*i).channel;
-	  Double_t is = (*i).signal;
-	  pmtList->Fill(ic,is);
-	  for (vector<pmt_hit>::iterator j=i;
-	       j < pmt_hit_list.end(); j++) {
+  cout << "ReadEvents: " << fPrefix << ": " << fEvents.size() << " events, "
+       << fHits.size() << " hits saved" << endl;
+}
 
-	    UInt_t jc = (*j).channel;
-	    Double_t js = (*j).signal;
+//------------------------------------------------------------------------------
 
-	    fQ[ic-1][jc-1] += is*js;
-	    if (jc != ic) fQ[jc-1][ic-1] += is*js;
-	  }
-	}
+THcCalCalib<THcPShGeom>* THcPShowerCalib::NewReader(string run) {
 
-	fNev++;
+  // Reader of one run of the list (see ReadRuns()), with the Cerenkov cuts
+  // of this object; the common cuts and gains are set by ReadRuns().
 
-      };   // if within enorm thresholds
+  THcPShowerCalib* r = new THcPShowerCalib(run, fNstart, fNstopRequested);
+  r->fHGCerMin = fHGCerMin;
+  r->fNGCerMin = fNGCerMin;
+  return r;
+}
 
-    };   // success in reading
+//------------------------------------------------------------------------------
 
-  };     // over entries
+void THcPShowerCalib::GetShTrack(THcPShTrack &trk, UInt_t iev) {
 
-  // Take averages.
+  //
+  // Set a Shower track from the saved event iev (same as ReadShRawTrack()).
+  //
 
-  fe0 /= fNev;
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-    fqe[i] /= fNev;
-    fq0[i] /= fNev;
-  }
+  cal_event &ev = fEvents[iev];
 
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++)
-    for (UInt_t j=0; j<THcPShTrack::fNpmts; j++)
-      fQ[i][j] /= fNev;
-
-  // Output vectors and matrixes, for debug purposes.
-  /*
-  ofstream q0out;
-  q0out.open("q0.deb",ios::out);
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++)
-    q0out << setprecision(20) << fq0[i] << " " << i << endl;
-  q0out.close();
-
-  ofstream qeout;
-  qeout.open("qe.deb",ios::out);
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++)
-    qeout << setprecision(20) << fqe[i] << " " << i << endl;
-  qeout.close();
-
-  ofstream Qout;
-  Qout.open("Q.deb",ios::out);
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++)
-    for (UInt_t j=0; j<THcPShTrack::fNpmts; j++)
-      Qout << setprecision(20) << fQ[i][j] << " " << i << " " << j << endl;
-  Qout.close();
-
-  ofstream sout;
-  sout.open("signal.deb",ios::out);
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-    double sig_sum = fq0[i] * fNev;
-    double sig2_sum = fQ[i][i] * fNev;
-    int nhit = fHitCount[i];
-    double sig = 0.;
-    double err = 0.;
-    if (nhit != 0) {
-      sig = sig_sum/nhit;
-      double rms2 = sig2_sum/nhit - (sig_sum/nhit)*(sig_sum/nhit);
-      if (rms2 > 0.) {
-	double rms = TMath::Sqrt(rms2);
-	err = rms/TMath::Sqrt(double(nhit));
-      }
-    }
+  trk.Reset(ev.p, ev.dp, ev.x+D_CALO_FP*ev.xp, ev.xp,
+  	    ev.y+D_CALO_FP*ev.yp, ev.yp);
 
-    sout << sig << " " << err << " " << nhit << " " << i << endl;
-  }
-  sout.close();
-  */
-};
+  for (UInt_t i=ev.first_hit; i<ev.first_hit+ev.nhits; i++)
+    trk.AddHit(fHits[i].adc, 0., fHits[i].blk);
+}
 
 //------------------------------------------------------------------------------
 
-void THcPShowerCalib::SolveAlphas() {
-
-  //
-  // Solve for the sought calibration constants, by use of the Root
-  // matrix algebra package.
-  //
-
-  TMatrixD Q(THcPShTrack::fNpmts,THcPShTrack::fNpmts);
-  TVectorD q0(THcPShTrack::fNpmts);
-  TVectorD qe(THcPShTrack::fNpmts);
-  TVectorD au(THcPShTrack::fNpmts);
-  TVectorD ac(THcPShTrack::fNpmts);
-  Bool_t ok;
-
-  cout << "Solving Alphas..." << endl;
-  cout << endl;
+void THcPShowerCalib::PrintHitCounts() {
 
-  // Print out hit numbers.
+  // Print out hit numbers, Preshower and Shower.
 
   cout << "Hit counts:" << endl;
   UInt_t j = 0;
@@ -859,114 +753,6 @@ void THcPShowerCalib::SolveAlphas() {
       cout << setw(6) << fHitCount[j++] << ",";
     cout << endl;
   }
-
-  // Initialize the vectors and the matrix of the Root algebra package.
-
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-    q0[i] = fq0[i];
-    qe[i] = fqe[i];
-    for (UInt_t k=0; k<THcPShTrack::fNpmts; k++) {
-      Q[i][k] = fQ[i][k];
-    }
-  }
-
-  // Sanity check.
-
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-
-    // Check zero hit channels: the vector and matrix elements should be 0.
-
-    if (fHitCount[i] == 0) {
-
-      if (q0[i] != 0. || qe[i] != 0.) {
-
-	cout << "*** Inconsistency in chanel " << i << ": # of hits  "
-	     << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i];
-
-	for (UInt_t k=0; k<THcPShTrack::fNpmts; k++) {
-	  if (Q[i][k] !=0. || Q[k][i] !=0.)
-	    cout << ", Q[" << i << "," << k << "]=" << Q[i][k]
-		 << ", Q[" << k << "," << i << "]=" << Q[k][i];
-	}
-
-	cout << " ***" << endl;
-      }
-    }
-
-    // The hit channels: the vector elements should be non zero.
-
-    if ( (fHitCount[i] != 0) && (q0[i] == 0. || qe[i] == 0.) ) {
-      cout << "*** Inconsistency in chanel " << i << ": # of hits  "
-	   << fHitCount[i] << ", q0=" << q0[i] << ", qe=" << qe[i]
-	   << " ***" << endl;
-    }
-
-  } //sanity check
-
-  // Low hit number channels: exclude from calculation. Assign all the
-  // correspondent elements 0, except self-correlation Q(i,i)=1.
-
-  cout << endl;
-  cout << "Channels with hit number less than " << fMinHitCount 
-       << " will not be calibrated." << endl;
-  cout << endl;
-
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-
-    if (fHitCount[i] < fMinHitCount) {
-      cout << "Channel " << i << ", " << fHitCount[i]
-	   << " hits, will not be calibrated." << endl;
-      q0[i] = 0.;
-      qe[i] = 0.;
-      for (UInt_t k=0; k<THcPShTrack::fNpmts; k++) {
-	Q[i][k] = 0.;
-	Q[k][i] = 0.;
-      }
-      Q[i][i] = 1.;
-    }
-
-  }
-
-  // Declare LU decomposition method for the correlation matrix Q.
-
-  TDecompLU lu(Q);
-  Double_t d1,d2;
-  lu.Det(d1,d2);
-  cout << "cond:" << lu.Condition() << endl;
-  cout << "det :" << d1*TMath::Power(2.,d2) << endl;
-  cout << "tol :" << lu.GetTol() << endl;
-
-  // Solve equation Q x au = qe for the 'unconstrained' calibration (gain)
-  // constants au.
-
-  au = lu.Solve(qe,ok);
-  cout << "au: ok=" << ok << endl;
-  //  au.Print();
-
-  // Find the sought 'constrained' calibration constants next.
-
-  Double_t t1 = fe0 - au * q0;         // temporary variable.
-  //  cout << "t1 =" << t1 << endl;
-
-  TVectorD Qiq0(THcPShTrack::fNpmts);   // an intermittent result
-  Qiq0 = lu.Solve(q0,ok);
-  cout << "Qiq0: ok=" << ok << endl;
-  //  Qiq0.Print();
-
-  Double_t t2 = q0 * Qiq0;             // another temporary variable
-  //  cout << "t2 =" << t2 << endl;
-
-  ac = (t1/t2) *Qiq0 + au;             // the sought gain constants
-  // cout << "ac:" << endl;
-  //  ac.Print();
-
-  // Assign the gain arrays.
-
-  for (UInt_t i=0; i<THcPShTrack::fNpmts; i++) {
-    falphaU[i] = au[i];
-    falphaC[i] = ac[i];
-  }
-
 }
 
 //------------------------------------------------------------------------------
@@ -986,51 +772,50 @@ void THcPShowerCalib::FillHEcal() {
 
   THcPShTrack trk;
 
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) {
-
-    if (ReadShRawTrack(trk, ientry)) {
-      //    trk.Print(cout);
-
-      //    trk.Print(cout);
-      //************wph*************
-      Double_t  xCalo= P_tr_x + P_tr_xp*D_CALO_FP ;  //could have done trk.GetX()
-      Double_t  yCalo= P_tr_y + P_tr_yp*D_CALO_FP ; 
-      Double_t  xExit= P_tr_x + P_tr_xp*D_EXIT_FP ; //but not here
-      Double_t  yExit= P_tr_y + P_tr_yp*D_EXIT_FP ;
-
-
-      trk.SetEs(falphaC);       // use the 'constrained' calibration constants
-      Double_t P = trk.GetP();
-      Double_t delta = trk.GetDp();
-      Double_t Enorm = trk.Enorm();
-
-      ////
-      if (Enorm>0) {
-	hEcal->Fill(Enorm);
-	hDPvsEcal->Fill(Enorm,delta,1.);
-	hCaloPos2->Fill(yCalo,xCalo);
-	hCaloPosWt->Fill(yCalo,xCalo,Enorm);
-	hCaloPosNorm->Divide(hCaloPosWt,hCaloPos2);	
-	hESHvsEPR->Fill(trk.EPRnorm(), trk.ESHnorm());
-	hETOTvsEPR->Fill(trk.EPRnorm(), trk.Enorm());      ////
-	yCalVsEp->Fill(Enorm, trk.GetY());
-	xCalVsEp->Fill(Enorm, trk.GetX());
-
-	//Plots with uncalibrated E
-	trk.SetEs(falpha0); 
-	hCaloPosWtU->Fill(yCalo,xCalo,trk.Enorm());
-	hCaloPosNormU->Divide(hCaloPosWtU,hCaloPos2);	
-
-	//Plots with PulseInt per track
-	//Set gain=1 then pulseInt=Enorm*P
-	trk.SetEs(falpha1);
-	hCaloPosWtPint->Fill(yCalo,xCalo,trk.Enorm()*trk.GetP());
-	hCaloPosNormPint->Divide(hCaloPosWtPint,hCaloPos);	
-	nev++;
-      }
+  for (UInt_t iev=0; iev<fEvents.size(); iev++) {
+
+    GetShTrack(trk, iev);
+    cal_event &ev = fEvents[iev];
+
+    //    trk.Print(cout);
+    //************wph*************
+    Double_t  xCalo= ev.x + ev.xp*D_CALO_FP ;  //could have done trk.GetX()
+    Double_t  yCalo= ev.y + ev.yp*D_CALO_FP ; 
+    Double_t  xExit= ev.x + ev.xp*D_EXIT_FP ; //but not here
+    Double_t  yExit= ev.y + ev.yp*D_EXIT_FP ;
+
+
+    trk.SetEs(falphaC);       // use the 'constrained' calibration constants
+    Double_t P = trk.GetP();
+    Double_t delta = trk.GetDp();
+    Double_t Enorm = trk.Enorm();
+
+    ////
+    if (Enorm>0) {
+      hEcal->Fill(Enorm);
+      hDPvsEcal->Fill(Enorm,delta,1.);
+      hCaloPos2->Fill(yCalo,xCalo);
+      hCaloPosWt->Fill(yCalo,xCalo,Enorm);
+      hCaloPosNorm->Divide(hCaloPosWt,hCaloPos2);	
+      hESHvsEPR->Fill(trk.EPRnorm(), trk.ESHnorm());
+      hETOTvsEPR->Fill(trk.EPRnorm(), trk.Enorm());      ////
+      yCalVsEp->Fill(Enorm, trk.GetY());
+      xCalVsEp->Fill(Enorm, trk.GetX());
+
+      //Plots with uncalibrated E
+      trk.SetEs(falpha0); 
+      hCaloPosWtU->Fill(yCalo,xCalo,trk.Enorm());
+      hCaloPosNormU->Divide(hCaloPosWtU,hCaloPos2);	
+
+      //Plots with PulseInt per track
+      //Set gain=1 then pulseInt=Enorm*P
+      trk.SetEs(falpha1);
+      hCaloPosWtPint->Fill(yCalo,xCalo,trk.Enorm()*trk.GetP());
+      hCaloPosNormPint->Divide(hCaloPosWtPint,hCaloPos);	
+      nev++;
+    }
 
 
-    }
 
     if (nev > 2000000) break;
   };
@@ -1050,13 +835,13 @@ void THcPShowerCalib::SaveAlphas() {
   //
 
   ofstream output;
-  char* fname = Form("pcal.param.%s_%d_%d", fPrefix.c_str(),
+  char* fname = Form("pcal.param.%s_%d_%d", GetTag().c_str(),
 		     fNstart, fNstopRequested);
   cout << "SaveAlphas: fname=" << fname << endl;
 
   output.open(fname,ios::out);
 
-  output << "; Calibration constants for file " << fPrefix 
+  output << "; Calibration constants for file(s) " << fPrefix 
 	 << ", " << fNev << " events processed" << endl;
   output << endl;
 
@@ -1174,18 +959,16 @@ void THcPShowerCalib::fillHits(){
 
 
 void THcPShowerCalib::fillCutBranch() {
-  Int_t nev=0;
-  for (UInt_t ientry=fNstart; ientry<fNstop; ientry++) 
+  // (cut variables of the first 200001 entries, saved by ReadEvents();
+  //  going to use this number to calculate percentages)
+  for (UInt_t i=0; i<fCutVars.size(); i++) 
     {
-    fTree->GetEntry(ientry);
-    hCer->Fill(P_ngcer_npeSum);
-    hP->Fill(P_tr_p);
-    hDelta->Fill(P_tr_tg_dp);
-    hBeta->Fill(P_tr_beta);
-    hClusTrk->Fill(P_cal_nclust,P_tr_n);  
-    nev++;
-    if (nev > 200000) break; //going to use this number to 
-                             //calculate percentages
+    cal_cutvars &c = fCutVars[i];
+    hCer->Fill(c.cer);
+    hP->Fill(c.p);
+    hDelta->Fill(c.dp);
+    hBeta->Fill(c.beta);
+    hClusTrk->Fill(c.nclust,c.ntrack);  
     }
 }
 #endif
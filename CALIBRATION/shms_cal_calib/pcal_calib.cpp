@@ -11,7 +11,7 @@
 // A steering Root script for the SHMS calorimeter calibration.
 //
 
-void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
+void pcal_calib(string Prefix, int nstop=-1, int nstart=0, int niter=0) {
 
   bool DRAW = 1;  //flag to draw extra plots
   bool SAVE = 1;  //flag to save plots in root file 
@@ -19,16 +19,22 @@ void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
   // Initialize the analysis clock
   clock_t t = clock();
  
-  cout << "Calibrating file " << Prefix << ".root, events "
+  // Prefix may be a comma separated list of runs, e.g.
+  // "shms_replay_488,shms_replay_489": the runs are read in parallel and
+  // calibrated on together (the events nstart -- nstop of each run).
+
+  cout << "Calibrating file(s) " << Prefix << ".root, events "
        << nstart << " -- " << nstop << endl;
 
   THcPShowerCalib theShowerCalib(Prefix, nstart, nstop);
+  string Tag = theShowerCalib.GetTag();   // for the output file names
 
   theShowerCalib.ReadThresholds();  // Read in threshold param-s and intial gains
   theShowerCalib.Init();            // Initialize constants and variables
   theShowerCalib.CalcThresholds();  // Thresholds on the uncalibrated Edep/P
   theShowerCalib.ComposeVMs();      // Compute vectors amd matrices for calib.
   theShowerCalib.SolveAlphas();     // Solve for the calibration constants
+  if (niter>0) theShowerCalib.Iterate(niter); // Re-window and re-solve
   theShowerCalib.SaveAlphas();      // Save the constants
   //theShowerCalib.SaveRawData();   // Save raw data into file for debuging
   theShowerCalib.FillHEcal();       // Fill histograms
@@ -122,7 +128,7 @@ void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
   for (Int_t i=0;i<=nCols;i++){tc[i]->Draw("same");} 
 
   // Save canvas in a pdf format.
-  Canvas->Print(Form("PDFs/%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+  Canvas->Print(Form("PDFs/%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
 
 // A bunch of diagnostic plots added Oct. 2019
 // SET DRAW==0 at beginning of code to avoid drawing the extras 
@@ -170,7 +176,7 @@ void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
   lb->SetLineColor(kRed);
   theShowerCalib.hExitPos->Draw("same colz");
 
-  Canvas2->Print(Form("PDFs/hits_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+  Canvas2->Print(Form("PDFs/hits_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
  //___________Canvas 3_______________
   Canvas3->Divide(3,2);
  //Cherenkov Cut
@@ -269,7 +275,7 @@ void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
   //__________________________________________________________
   pt->Draw();
 
-  Canvas3->Print(Form("PDFs/cuts_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+  Canvas3->Print(Form("PDFs/cuts_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
 
  //___________Canvas 4_______________
  Canvas4->Divide(3,2);
@@ -325,12 +331,12 @@ void pcal_calib(string Prefix, int nstop=-1, int nstart=0) {
    t[i]->Draw("same");
  }
 
-  Canvas4->Print(Form("PDFs/pInt_%s_%d_%d.pdf",Prefix.c_str(),nstart,nstop));
+  Canvas4->Print(Form("PDFs/pInt_%s_%d_%d.pdf",Tag.c_str(),nstart,nstop));
 
  }
 
  if (SAVE==1){
-  TFile* froot=new TFile(Form("%s_%d_%d.root",Prefix.c_str(),nstart,nstop),
+  TFile* froot=new TFile(Form("%s_%d_%d.root",Tag.c_str(),nstart,nstop),
 			 "RECREATE");
   cout << "Savings histograms...." << endl;
   theShowerCalib.hEunc->Write();
@@ -102,4 +102,46 @@ void extract_2d_hist(TH2F *h2, TString xlabel, TString ylabel, TString out_fname
 
 
 
+//_______________________________________________________________________________
+template<class H>
+void rand_subtract(H *h_real, H *h_rand, H *h_sub, Double_t scale)
+{
+
+  /*
+    Brief: This function stores the random-subtracted histogram (h_real - scale * h_rand) in h_sub,
+    equivalent to h_sub->Add(h_real, h_rand, 1, -scale), but done in a single pass over the raw bin
+    arrays (including under/overflow bins). h_real and h_rand are NOT modified, so the function may be
+    called repeatedly (e.g. on every online poll) with the same (un-scaled) random coincidence histogram.
+    H may be TH1F or TH2F, and all three histograms must have the same binning.
+  */
+
+  //Make sure sum of weights squared is stored (for bin errors)
+  if(h_real->GetSumw2N()==0) h_real->Sumw2();
+  if(h_rand->GetSumw2N()==0) h_rand->Sumw2();
+  if(h_sub->GetSumw2N()==0)  h_sub->Sumw2();
+
+  Int_t ncells = h_real->GetNcells();  // total number of bins (incl. under/overflow)
+  
+  Float_t *c_real = h_real->GetArray();
+  Float_t *c_rand = h_rand->GetArray();
+  Float_t *c_sub  = h_sub->GetArray();
+
+  Double_t *w2_real = h_real->GetSumw2()->GetArray();
+  Double_t *w2_rand = h_rand->GetSumw2()->GetArray();
+  Double_t *w2_sub  = h_sub->GetSumw2()->GetArray();
+
+  Double_t scale2 = scale * scale;
+  
+  for(Int_t i=0; i<ncells; i++){
+    c_sub[i]  = c_real[i]  - scale  * c_rand[i];
+    w2_sub[i] = w2_real[i] + scale2 * w2_rand[i];
+  }
+
+  //Re-compute the histogram statistics from the new bin contents (keeping the number of entries as TH1::Add would)
+  h_sub->ResetStats();
+  h_sub->SetEntries( TMath::Abs(h_real->GetEntries() - h_rand->GetEntries()) );
+  
+}
+
+
 #endif
@@ -1,24 +1,138 @@
+#ifndef READ_CSV_H
+#define READ_CSV_H
+
 #include "parse_utils.h"
 #include <vector>
+#include <map>
 #include <numeric>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <cstdlib>
+#include <sys/stat.h>
+
+
+//_______________________________________________________________________________
+struct csv_table
+{
+  /*
+    brief: a CSV file parsed into numeric columns (see csv_load()).
+    columns are stored in header order, and can be looked up by name via col_idx
+  */
+
+  string fname;
+  time_t mtime = 0;                 // modification time / size of file when parsed
+  off_t fsize = 0;
+  vector<string> header;            // column names
+  map<string, int> col_idx;         // column name -> column index
+  vector< vector<double> > cols;    // numeric columns
+};
+
+//_______________________________________________________________________________
+csv_table &csv_load(string csv_file="", bool force_reload=false){
+
+  /*
+    brief: parses a comma-separated values (CSV) file ONCE into numeric columns, and caches
+    the result by file path. The file is only re-parsed if its modification time (or size) changed,
+    so requesting many columns of the same file (e.g. read_csv() below) costs a single read.
+
+    The data rows are tokenized in place (no per-field string allocation): each field is converted
+    with strtod() directly from the file buffer, and the scan skips to the next ',' or end of line.
+
+    force_reload: ignore the cached table and re-parse the file (e.g. for timing, see read_csv_benchmark.C)
+
+    same format assumptions as read_csv() (see below)
+  */
+
+  static map<string, csv_table> cache;
+
+  struct stat st;
+  bool found = stat(csv_file.c_str(), &st)==0;
+  time_t mtime = found ? st.st_mtime : 0;
+  off_t fsize  = found ? st.st_size  : 0;
+
+  map<string, csv_table>::iterator it = cache.find(csv_file);
+  if(!force_reload && it!=cache.end() && it->second.mtime==mtime && it->second.fsize==fsize) return it->second;
+
+  csv_table &t = cache[csv_file];
+  t = csv_table();
+  t.fname = csv_file;
+  t.mtime = mtime;
+  t.fsize = fsize;
+
+  ifstream myFileStream(csv_file.c_str(), ios::in | ios::binary);
+
+  if(!myFileStream.is_open()){
+    cout << Form("File %s failed to open",csv_file.c_str()) << endl;
+    return t;
+  }
+
+  // read the whole file into memory
+  string buf( (istreambuf_iterator<char>(myFileStream)), istreambuf_iterator<char>() );
+  myFileStream.close();
 
+  const char *p   = buf.c_str();
+  const char *end = p + buf.size();
+  unsigned int ncols = 0;
+
+  while(p < end) {
+
+    // line limits [p, eol)
+    const char *eol = p;
+    while(eol < end && *eol!='\n') eol++;
+
+    // ignore comments and empty lines
+    if(p==eol || *p=='#' || *p=='\r') { p = eol + 1; continue; }
+
+    // first non-comment row (headers)
+    if(t.header.empty()) {
 
+      t.header = parse_line(string(p, eol), ',');
+      ncols = t.header.size();
+      t.cols.resize(ncols);
+
+      for (unsigned int i=0; i < ncols; i++){
+	// remove leading/trainling spaces in header names
+	t.header[i] = trim(t.header[i]);
+	t.col_idx[t.header[i]] = i;
+      }
+    }
+
+    // numeric rows
+    else {
+
+      const char *f = p;
+      for (unsigned int i=0; i < ncols; i++){
+
+	char *f_end;
+	t.cols[i].push_back( f < eol ? strtod(f, &f_end) : 0. );
+
+	// skip to the next field
+	while(f < eol && *f!=',') f++;
+	f++;
+      }
+    }
+
+    p = eol + 1;
+  }
+
+  return t;
+}
+
+//_______________________________________________________________________________
 vector<double> read_csv(string csv_file="", string col_header=""){
 
   /*
     brief: reads a comma-separated values (CSV) file and returns a vector
-    of requested column by user. 
+    of requested column by user.
 
-    assumptions: 
-    no white-spaces, 
-    comments are denoted by '#', 
+    assumptions:
+    no white-spaces,
+    comments are denoted by '#',
     first non-commented line is header (name of columns)
     all rows after 1st row are numeric string values (and will be converted to double)
-    
+
     example of format accepted:
     my_file.csv
     ----------------------------
@@ -37,103 +151,34 @@ vector<double> read_csv(string csv_file="", string col_header=""){
     root [0] .L read_csv.cpp
     root [1] read_csv("my_file.csv", "header_2")
     (std::vector<double>) { 30.100000, 12.200000, 0.41000000 }
-  
+
     If using from a c++ code, please include this file in header as:
-    #include "read_csv.cpp"    
-    
+    #include "read_csv.cpp"
+
     then the fucntion may be called within the code.
 
+    NOTE: the file is parsed only once (see csv_load()), so reading several columns
+    of the same file does not re-read it. (benchmark: read_csv_benchmark.C)
+
   */
-  
-  
-  ifstream myFileStream(csv_file.c_str());
 
-  if(!myFileStream.is_open()){
-    cout << Form("File %s failed to open",csv_file.c_str()) << endl;
-   
-  }
+  csv_table &t = csv_load(csv_file);
 
   if( col_header.empty() ) {
     cout << "Empty column header !" << endl;
     cout << csv_file.c_str() << "Please select one of the following column headers --- > " << endl;
-  }
-
-  string line;
-  vector<string> parsed_header;
-  int col_idx;
-  string row_str;
-  double row_value;
-  vector<double> col_vec;
-  
-  int row_cnt = 0;
-
-  // read the file: line by line
-  while(getline(myFileStream, line)) {
-    stringstream ss(line);
-
-    // ignore comments
-    if(line[0]=='#') continue;
-
-    
-    // first non-comment row (headers)
-    if (row_cnt==0){
 
-      // parsed vector, whose elemetnts are the column headers
-      parsed_header = parse_line(line, ',');
-
-      // loop over each header
-      for (unsigned int i=0; i < parsed_header.size(); i++){
-	// remove leading/trainling spaces in header names
-	parsed_header[i] = trim(parsed_header[i]);
-
-	// user help:  display headers if none detected from user
-	if(col_header.empty()){
-	  cout << parsed_header[i] << endl;
-
-	  if(i == parsed_header.size() - 1 ) {
-	    cout << "reached the end of file " << endl;
-	    exit(0);
-	  }
-	}
-	
-	if (parsed_header[i] == col_header.c_str() ) {
-	  col_idx = i; // store the column index requested by user
-
-	}
-      }  
-    }
-
-
-    // loop over each column index
-    for (unsigned int i=0; i < parsed_header.size(); i++){
-
-      // get the entire row index
-      getline(ss, row_str, ',');
-
-      // require user-requested column index
-      if (i==col_idx){
-
-	// convert row string to numeric value for storing in array
-	if(row_cnt!=0) {
-
-	  row_value = stod(row_str);
-
-	  // add each numeric row value to the user-requested column vector
-	  col_vec.push_back(row_value);
-
-	}
-
-      }
-      
-    }
-
-    
-    // row counter
-    row_cnt++;
+    // user help:  display headers if none detected from user
+    for (unsigned int i=0; i < t.header.size(); i++){ cout << t.header[i] << endl; }
+    cout << "reached the end of file " << endl;
+    exit(0);
   }
-  
-  myFileStream.close();
 
-  // return numerical column data vector 
-  return col_vec;
+  map<string, int>::iterator it = t.col_idx.find(col_header);
+  if(it==t.col_idx.end()) return vector<double>();
+
+  // return numerical column data vector
+  return t.cols[it->second];
 }
+
+#endif
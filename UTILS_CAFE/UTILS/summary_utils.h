@@ -0,0 +1,225 @@
+#ifndef SUMMARY_UTILS_H
+#define SUMMARY_UTILS_H
+
+/*
+  Brief: run-summary store for the CaFe report summary (.csv) files
+
+  Writing (see baseAnalyzer::WriteReportSummary()):
+  The file format is unchanged ( '#' commented parameters block, column header line, one row per run ),
+  but each row is written with summary_write_run(), which
+
+    1) locks the file (many farm jobs may write to the same summary file at the same time),
+    2) checks the column header of the existing file against the declared schema (header line),
+    3) replaces the row of the same run (if the run was re-analyzed) instead of appending a duplicate,
+    4) writes the updated table to a temporary file and renames it over the old one (atomic update).
+
+  Reading (see post_analysis/scripts/cafe_plot_utils.h):
+  summary_load() parses the header parameters of a summary file only ONCE, and the numeric columns are
+  parsed only once by csv_load() (read_csv.h, the same cache used by read_csv()), so subsequent calls
+  (e.g. get_header("hms_trk_eff"), get_header("hms_trk_eff_err"), get_param(...)) do not re-read the file
+
+    summary_table &t = summary_load("cafe_prod_C12_MF_report_summary.csv");
+    vector<double> charge = t.col("charge");
+    double transparency   = t.param("transparency");
+
+*/
+
+#include "parse_utils.h"
+#include "read_csv.h"
+#include <vector>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+//_______________________________________________________________________________
+struct summary_table
+{
+  string fname;
+  time_t mtime = 0;                       // modification time / size of file when loaded
+  off_t fsize = 0;
+  map<string, string> params;             // '# key: value' header parameters
+
+  // column header and numeric rows are NOT copied here: they are read from the (single) csv_load() cache
+  const vector<string> &header() { return csv_load(fname).header; }
+
+  vector<double> col(string name) {
+
+    csv_table &c = csv_load(fname);
+    
+    if(c.col_idx.find(name)==c.col_idx.end()){
+      cout << Form("summary_table: column %s NOT found in %s", name.c_str(), fname.c_str()) << endl;
+      return vector<double>();
+    }
+    return c.cols[ c.col_idx[name] ];
+  }
+
+  double param(string name) {
+
+    if(params.find(name)!=params.end()) return stod(params[name]);
+
+    // parameter names may be followed by units, e.g. "target_areal_density [g/cm2]"
+    for(map<string, string>::iterator it=params.begin(); it!=params.end(); ++it){
+      if(it->first.find(name + " ")==0) return stod(it->second);
+    }
+
+    cout << Form("summary_table: parameter %s NOT found in %s", name.c_str(), fname.c_str()) << endl;
+    return 0.;
+  }
+};
+
+//_______________________________________________________________________________
+bool summary_write_run(string fname, string comments, string header, int run, string row)
+{
+
+  /*
+    brief: write (or replace) the summary row of a given run
+
+    fname    : summary .csv file name
+    comments : '#' commented parameters block (only written if the file does not exist yet)
+    header   : column header line (schema), e.g. "run,beam_time,charge,..." (1st column must be the run number)
+    run      : run number of this row
+    row      : comma-separated values of this run (same number of columns as header)
+
+    returns false (and leaves the file untouched) if the existing file has a different column header
+  */
+
+  if(parse_line(row, ',').size() != parse_line(header, ',').size()){
+    cout << Form("summary_write_run: row of run %d has %d columns, but header has %d ! ! !", run,
+		 (int)parse_line(row, ',').size(), (int)parse_line(header, ',').size()) << endl;
+    return false;
+  }
+
+  // exclusive lock (released when lock file is closed), to serialize concurrent writers
+  string lock_fname = fname + ".lock";
+  int lock_fd = open(lock_fname.c_str(), O_CREAT | O_RDWR, 0666);
+  if(lock_fd<0 || flock(lock_fd, LOCK_EX)!=0){
+    cout << Form("summary_write_run: could NOT lock %s ! ! !", lock_fname.c_str()) << endl;
+    if(lock_fd>=0) close(lock_fd);
+    return false;
+  }
+
+  // read existing file (if any): keep comment block and every row of a different run
+  ifstream ifile(fname.c_str());
+
+  string line;
+  string file_comments;
+  string file_header;
+  vector<string> file_rows;
+  bool replaced = false;
+
+  while(getline(ifile, line)) {
+
+    if(line.empty()) continue;
+
+    if(line[0]=='#') { file_comments += line + "\n"; continue; }
+
+    if(file_header.empty()) { file_header = line; continue; }
+
+    string run_str = parse_line(line, ',')[0];
+    if(atoi(trim(run_str).c_str())==run) { replaced = true; continue; }
+
+    file_rows.push_back(line);
+  }
+  ifile.close();
+
+  if(file_header.empty()) {
+    file_comments = comments;
+    file_header   = header;
+  }
+
+  string h1 = file_header, h2 = header;
+  if(trim(h1) != trim(h2)){
+    cout << Form("summary_write_run: column header of %s does NOT match the current schema, run %d NOT written ! ! !", fname.c_str(), run) << endl;
+    flock(lock_fd, LOCK_UN);
+    close(lock_fd);
+    return false;
+  }
+
+  file_rows.push_back(row);
+
+  // write the full table to a temporary file and atomically replace the old one
+  string tmp_fname = Form("%s.tmp.%d", fname.c_str(), (int)getpid());
+  ofstream ofile(tmp_fname.c_str());
+
+  ofile << file_comments;
+  ofile << file_header << endl;
+  for(unsigned int i=0; i<file_rows.size(); i++){ ofile << file_rows[i] << endl; }
+  ofile.close();
+
+  bool ok = !ofile.fail() && rename(tmp_fname.c_str(), fname.c_str())==0;
+  if(!ok) {
+    cout << Form("summary_write_run: could NOT write %s ! ! !", fname.c_str()) << endl;
+    remove(tmp_fname.c_str());
+  }
+  else if(replaced) {
+    cout << Form("summary_write_run: replaced existing entry of run %d in %s", run, fname.c_str()) << endl;
+  }
+
+  flock(lock_fd, LOCK_UN);
+  close(lock_fd);
+
+  return ok;
+}
+
+//_______________________________________________________________________________
+summary_table &summary_load(string fname)
+{
+
+  /*
+    brief: read the header parameters of a summary .csv file ONCE (cached by file name,
+    and re-read only if the file was modified (mtime or size) since it was loaded).
+    The numeric columns are parsed and cached by csv_load() (see summary_table::col())
+  */
+
+  static map<string, summary_table> cache;
+
+  struct stat st;
+  bool found = stat(fname.c_str(), &st)==0;
+  time_t mtime = found ? st.st_mtime : 0;
+  off_t fsize  = found ? st.st_size  : 0;
+
+  map<string, summary_table>::iterator it = cache.find(fname);
+  if(it!=cache.end() && it->second.mtime==mtime && it->second.fsize==fsize) return it->second;
+
+  summary_table &t = cache[fname];
+  t = summary_table();
+  t.fname = fname;
+  t.mtime = mtime;
+  t.fsize = fsize;
+
+  ifstream ifile(fname.c_str());
+  if(!ifile.is_open()){
+    cout << Form("summary_load: File %s failed to open", fname.c_str()) << endl;
+    return t;
+  }
+
+  // header parameters ('# key: value'), in the commented block above the column header
+  string line;
+  while(getline(ifile, line)) {
+
+    if(line.empty()) continue;
+    if(line[0]!='#') break;
+
+    size_t pos = line.find(':');
+    if(pos!=string::npos){
+      string key = line.substr(1, pos-1);
+      string val = line.substr(pos+1);
+      t.params[trim(key)] = trim(val);
+    }
+  }
+
+  ifile.close();
+
+  return t;
+}
+
+#endif
@@ -5,6 +5,8 @@ Date Created: August 22, 2020
 */
 
 #include "baseAnalyzer.h"
+#include "ROOT/TProcessExecutor.hxx"  // parallel (forked) rendering of online plot pages, see MakePlots()
+#include "ROOT/TSeq.hxx"
 #include <iostream>
 #include <stdio.h>
 using namespace std;
@@ -94,6 +96,7 @@ void baseAnalyzer::Init(){
   cout << "Initializing Pointers . . ." << endl;
   //Initialize TFile Pointers
   inROOT  = NULL;
+  inROOT_scaler = NULL;
   outROOT = NULL;
   
   //Initialize TTree Pointers
@@ -105,6 +108,8 @@ void baseAnalyzer::Init(){
   //Initialize Scaler Pointer
   evt_flag_bcm = NULL;   //scaler read array of 0 or 1 (determine if scaler read passed bcm cut)
   scal_evt_num = NULL;
+  scal_slice   = NULL;   //scaler read array of time slice index (see WriteTimeSlices())
+  scal_bcm_mask = NULL;  //scaler read array of bcm scan points passed (see WriteBCMScan())
 
   //Initialize TList Pointers
   pid_HList = NULL;
@@ -294,45 +299,12 @@ void baseAnalyzer::Init(){
 
 
   //----------------------------------
-  // Selected Histograms for Random
-  // Coincidence Background Subtraction
+  // Histograms for Random Coincidence
+  // Background Subtraction (see AddRandHist())
   //----------------------------------
 
-  H_ep_ctime_rand      =  NULL; 
-  H_ep_ctime_rand_sub  =  NULL;     
-                       		
-  H_W_rand  =  NULL;	       	
-  H_W_rand_sub  =  NULL;	
-                       		       
-  H_Q2_rand  =  NULL;	       	
-  H_Q2_rand_sub  =  NULL;       
-                       		
-  H_xbj_rand  =  NULL;	       	
-  H_xbj_rand_sub  =  NULL;      
-                       		
-  H_nu_rand  =  NULL;	       	
-  H_nu_rand_sub  =  NULL;       
-                       		
-  H_q_rand  =  NULL;	       	
-  H_q_rand_sub  =  NULL;	
-                       		       
-  H_Em_rand  =  NULL;	       	
-  H_Em_rand_sub  =  NULL;       
-                       		
-  H_Em_nuc_rand  =  NULL;       
-  H_Em_nuc_rand_sub  =  NULL;   
-                       		
-  H_Pm_rand  =  NULL;	       	
-  H_Pm_rand_sub  =  NULL;       
-                       		
-  H_MM_rand  =  NULL;	       	
-  H_MM_rand_sub  =  NULL;       
-                       		
-  H_thxq_rand  =  NULL;	       	
-  H_thxq_rand_sub  =  NULL;     
-                       		
-  H_thrq_rand  =  NULL;	       	
-  H_thrq_rand_sub = NULL;     	
+  rand_H1.clear();
+  rand_H2.clear();
 
   //----------------------------------------------------------------
   // DATA QUALITY CHECK / CUTS STUDY Histograms
@@ -718,11 +690,14 @@ baseAnalyzer::~baseAnalyzer()
 
   //Delete FileName Pointers
   delete inROOT; inROOT   = NULL;
+  delete inROOT_scaler; inROOT_scaler = NULL;
   delete outROOT; outROOT = NULL;
 
   //Delete Scaler related event flag
   delete [] evt_flag_bcm; evt_flag_bcm = NULL;
   delete [] scal_evt_num; scal_evt_num = NULL;
+  delete [] scal_slice;   scal_slice   = NULL;
+  delete [] scal_bcm_mask; scal_bcm_mask = NULL;
 
   //Delete TList Pointers
   delete pid_HList;     pid_HList = NULL;
@@ -902,45 +877,14 @@ baseAnalyzer::~baseAnalyzer()
   delete H_exfp_vs_eyfp;        H_exfp_vs_eyfp    = NULL;
 
   //----------------------------------
-  // Selected Histograms for Random
-  // Coincidence Background Subtraction
+  // Histograms for Random Coincidence
+  // Background Subtraction (see AddRandHist())
   //----------------------------------
-  
-  delete H_ep_ctime_rand;         H_ep_ctime_rand      =  NULL; 
-  delete H_ep_ctime_rand_sub; 	  H_ep_ctime_rand_sub  =  NULL; 
-                       		                       		
-  delete H_W_rand;	       	  H_W_rand  =  NULL;	       	
-  delete H_W_rand_sub;	       	  H_W_rand_sub  =  NULL;	
-                       		                       		
-  delete H_Q2_rand;	       	  H_Q2_rand  =  NULL;	       	
-  delete H_Q2_rand_sub;       	  H_Q2_rand_sub  =  NULL;       
-                       		                       		
-  delete H_xbj_rand;	       	  H_xbj_rand  =  NULL;	       	
-  delete H_xbj_rand_sub;      	  H_xbj_rand_sub  =  NULL;      
-                       		                       		
-  delete H_nu_rand;	       	  H_nu_rand  =  NULL;	       	
-  delete H_nu_rand_sub;       	  H_nu_rand_sub  =  NULL;       
-                       		                       		
-  delete H_q_rand;	       	  H_q_rand  =  NULL;	       	
-  delete H_q_rand_sub;	       	  H_q_rand_sub  =  NULL;	
-                       		                       		
-  delete H_Em_rand;	       	  H_Em_rand  =  NULL;	       	
-  delete H_Em_rand_sub;       	  H_Em_rand_sub  =  NULL;       
-                       		                       		
-  delete H_Em_nuc_rand;       	  H_Em_nuc_rand  =  NULL;       
-  delete H_Em_nuc_rand_sub;   	  H_Em_nuc_rand_sub  =  NULL;   
-                       		                       		
-  delete H_Pm_rand;	       	  H_Pm_rand  =  NULL;	       	
-  delete H_Pm_rand_sub;       	  H_Pm_rand_sub  =  NULL;       
-                       		                       		
-  delete H_MM_rand;	       	  H_MM_rand  =  NULL;	       	
-  delete H_MM_rand_sub;       	  H_MM_rand_sub  =  NULL;       
-                       		                       		
-  delete H_thxq_rand;	       	  H_thxq_rand  =  NULL;	       	
-  delete H_thxq_rand_sub;     	  H_thxq_rand_sub  =  NULL;     
-                       		                       		
-  delete H_thrq_rand;	       	  H_thrq_rand  =  NULL;	       	
-  delete H_thrq_rand_sub;     	  H_thrq_rand_sub = NULL;     	
+
+  for(unsigned int i=0; i<rand_H1.size(); i++) { delete rand_H1[i].rand; delete rand_H1[i].sub; }
+  for(unsigned int i=0; i<rand_H2.size(); i++) { delete rand_H2[i].rand; delete rand_H2[i].sub; }
+  rand_H1.clear();
+  rand_H2.clear();
 
   
   //----------------------------------------------------------------
@@ -1430,11 +1374,58 @@ void baseAnalyzer::ReadInputFile(bool set_input_fnames=true, bool set_output_fna
       //Define Output (.txt) File Name Pattern (analysis report is written to this file) -- short report on a per-run basis
       temp = trim(split(FindString("output_REPORTPattern", input_FileNamePattern.Data())[0], '=')[1]);
       output_ReportFileName = Form(temp.Data(), replay_type.Data(), tgt_type.Data(), analysis_cut.Data(), run, evtNum);
+
+      //Define Output (.csv) File Name Pattern (yield / normalization per time slice is written to this file, if time_slice_flag=1)
+      temp = trim(split(FindString("output_TimeSlicePattern", input_FileNamePattern.Data())[0], '=')[1]);
+      output_TimeSliceFileName = Form(temp.Data(), replay_type.Data(), tgt_type.Data(), analysis_cut.Data(), run, evtNum);
+
+      //Define Output (.csv) File Name Pattern (yield / normalization per bcm scan point is written to this file, if bcm_scan_flag=1)
+      temp = trim(split(FindString("output_BCMScanPattern", input_FileNamePattern.Data())[0], '=')[1]);
+      output_BCMScanFileName = Form(temp.Data(), replay_type.Data(), tgt_type.Data(), analysis_cut.Data(), run, evtNum);
       
     } 
 
   }
   
+  //==========================================
+  //  READ TIME-SLICED NORMALIZATION OPTIONS
+  //==========================================
+
+  if(set_input_fnames) {
+    time_slice_flag  = stoi(split(FindString("time_slice_flag", input_CutFileName.Data())[0], '=')[1]);
+    time_slice_width = stod(split(FindString("time_slice_width", input_CutFileName.Data())[0], '=')[1]);
+  }
+
+  //==========================================
+  //  READ BCM CURRENT THRESHOLD SCAN OPTIONS
+  //==========================================
+
+  if(set_input_fnames) {
+    bcm_scan_flag = stoi(split(FindString("bcm_scan_flag", input_CutFileName.Data())[0], '=')[1]);
+    if(bcm_scan_flag){
+      SetBCMScan( split(FindString("bcm_scan_type", input_CutFileName.Data())[0], '=')[1],
+		  split(FindString("bcm_scan_thrs", input_CutFileName.Data())[0], '=')[1] );
+    }
+  }
+
+  //==========================================
+  //  READ FOLLOW (ONLINE) MODE OPTIONS
+  //==========================================
+
+  if(set_input_fnames) {
+    follow_poll_sec    = stoi(split(FindString("follow_poll_sec", input_CutFileName.Data())[0], '=')[1]);
+    follow_timeout_sec = stoi(split(FindString("follow_timeout_sec", input_CutFileName.Data())[0], '=')[1]);
+    follow_min_entries = stoll(split(FindString("follow_min_entries", input_CutFileName.Data())[0], '=')[1]);
+  }
+
+  //==========================================
+  //  READ ONLINE PLOT BOOK OPTIONS
+  //==========================================
+
+  if(set_input_fnames) {
+    online_plots_nworkers = stoi(split(FindString("online_plots_nworkers", input_CutFileName.Data())[0], '=')[1]);
+  }
+  
   //==========================================
   //     READ TRACKING EFFICIENCY CUTS
   //==========================================
@@ -2609,65 +2600,139 @@ void baseAnalyzer::CreateHist()
 
 
   
-  //---------------------------------------------------------------------
-  //---------HISTOGRAM CATEGORY: RANDOM COIN. BACKGROUND-----------------
-  //---------------------------------------------------------------------
-
-  H_ep_ctime_rand   = new TH1F("H_ep_ctime_rand", "ep Coincidence Time; ep Coincidence Time [ns]; Counts ", coin_nbins, coin_xmin, coin_xmax);
-  H_W_rand          = new TH1F("H_W_rand",        "Invariant Mass, W", W_nbins, W_xmin, W_xmax); 
-  H_Q2_rand         = new TH1F("H_Q2_rand",       "4-Momentum Transfer, Q^{2}", Q2_nbins, Q2_xmin, Q2_xmax); 
-  H_xbj_rand        = new TH1F("H_xbj_rand",      "x-Bjorken", X_nbins, X_xmin, X_xmax);  
-  H_nu_rand         = new TH1F("H_nu_rand",       "Energy Transfer, #nu", nu_nbins, nu_xmin, nu_xmax); 
-  H_q_rand          = new TH1F("H_q_rand",        "3-Momentum Transfer, |#vec{q}|", q_nbins, q_xmin, q_xmax);
-  H_Em_rand         = new TH1F("H_Em_rand",     "Missing Energy", Em_nbins, Em_xmin, Em_xmax);   
-  H_Em_nuc_rand     = new TH1F("H_Em_nuc_rand", "Nuclear Missing Energy", Em_nuc_nbins, Em_nuc_xmin, Em_nuc_xmax); 
-  H_Pm_rand         = new TH1F("H_Pm_rand",     "Missing Momentum, P_{miss}", Pm_nbins, Pm_xmin, Pm_xmax);
-  H_MM_rand         = new TH1F("H_MM_rand",     "Missing Mass, M_{miss}", MM_nbins, MM_xmin, MM_xmax);        
-  H_thxq_rand       = new TH1F("H_thxq_rand",   "In-Plane Angle, #theta_{pq}", thxq_nbins, thxq_xmin, thxq_xmax);
-  H_thrq_rand       = new TH1F("H_thrq_rand",   "In-Plane Angle, #theta_{rq}", thrq_nbins, thrq_xmin, thrq_xmax);
-  
-  rand_HList->Add( H_ep_ctime_rand );
-  rand_HList->Add( H_W_rand        );
-  rand_HList->Add( H_Q2_rand       );
-  rand_HList->Add( H_xbj_rand      );
-  rand_HList->Add( H_nu_rand       );
-  rand_HList->Add( H_q_rand        );
-  rand_HList->Add( H_Em_rand       );
-  rand_HList->Add( H_Em_nuc_rand   );
-  rand_HList->Add( H_Pm_rand       );
-  rand_HList->Add( H_MM_rand       );
-  rand_HList->Add( H_thxq_rand     );
-  rand_HList->Add( H_thrq_rand     );
-
-  //--------------------------------------------------------------------------------
-  //---------HISTOGRAM CATEGORY: RANDOM-SUBTRACTED COIN. BACKGROUND-----------------
-  //--------------------------------------------------------------------------------
-
-  H_ep_ctime_rand_sub   = new TH1F("H_ep_ctime_rand_sub", "ep Coincidence Time; ep Coincidence Time [ns]; Counts ", coin_nbins, coin_xmin, coin_xmax);
-  H_W_rand_sub          = new TH1F("H_W_rand_sub",        "Invariant Mass, W", W_nbins, W_xmin, W_xmax); 
-  H_Q2_rand_sub         = new TH1F("H_Q2_rand_sub",       "4-Momentum Transfer, Q^{2}", Q2_nbins, Q2_xmin, Q2_xmax); 
-  H_xbj_rand_sub        = new TH1F("H_xbj_rand_sub",      "x-Bjorken", X_nbins, X_xmin, X_xmax);  
-  H_nu_rand_sub         = new TH1F("H_nu_rand_sub",       "Energy Transfer, #nu", nu_nbins, nu_xmin, nu_xmax); 
-  H_q_rand_sub          = new TH1F("H_q_rand_sub",        "3-Momentum Transfer, |#vec{q}|", q_nbins, q_xmin, q_xmax);
-  H_Em_rand_sub         = new TH1F("H_Em_rand_sub",     "Missing Energy", Em_nbins, Em_xmin, Em_xmax);   
-  H_Em_nuc_rand_sub     = new TH1F("H_Em_nuc_rand_sub", "Nuclear Missing Energy", Em_nuc_nbins, Em_nuc_xmin, Em_nuc_xmax); 
-  H_Pm_rand_sub         = new TH1F("H_Pm_rand_sub",     "Missing Momentum, P_{miss}", Pm_nbins, Pm_xmin, Pm_xmax);
-  H_MM_rand_sub         = new TH1F("H_MM_rand_sub",     "Missing Mass, M_{miss}", MM_nbins, MM_xmin, MM_xmax);        
-  H_thxq_rand_sub       = new TH1F("H_thxq_rand_sub",   "In-Plane Angle, #theta_{pq}", thxq_nbins, thxq_xmin, thxq_xmax);
-  H_thrq_rand_sub       = new TH1F("H_thrq_rand_sub",   "In-Plane Angle, #theta_{rq}", thrq_nbins, thrq_xmin, thrq_xmax);
-  
-  randSub_HList->Add( H_ep_ctime_rand_sub );
-  randSub_HList->Add( H_W_rand_sub        );
-  randSub_HList->Add( H_Q2_rand_sub       );
-  randSub_HList->Add( H_xbj_rand_sub      );
-  randSub_HList->Add( H_nu_rand_sub       );
-  randSub_HList->Add( H_q_rand_sub        );
-  randSub_HList->Add( H_Em_rand_sub       );
-  randSub_HList->Add( H_Em_nuc_rand_sub   );
-  randSub_HList->Add( H_Pm_rand_sub       );
-  randSub_HList->Add( H_MM_rand_sub       );
-  randSub_HList->Add( H_thxq_rand_sub     );
-  randSub_HList->Add( H_thrq_rand_sub     );
+  //---------------------------------------------------------------------------------------
+  //---------HISTOGRAM CATEGORY: RANDOM COIN. BACKGROUND / RANDOM-SUBTRACTED-----------------
+  //---------------------------------------------------------------------------------------
+
+  // Every histogram filled under the main coin. peak (see FillCoinHistos()) is registered here, which creates its
+  // *_rand (stored in rand_HList) and *_rand_sub (stored in randSub_HList) twins. Any histogram added to
+  // FillCoinHistos() must also be registered here to be random-subtracted.
+  
+  //PID
+  AddRandHist( H_ep_ctime_real   );  // -> H_ep_ctime_rand, H_ep_ctime_rand_sub
+  AddRandHist( H_hCerNpeSum      );
+  AddRandHist( H_hCalEtotNorm    );
+  AddRandHist( H_hCalEtotTrkNorm );
+  AddRandHist( H_hHodBetaNtrk    );
+  AddRandHist( H_hHodBetaTrk     );
+  AddRandHist( H_pNGCerNpeSum    );
+  AddRandHist( H_pHGCerNpeSum    );
+  AddRandHist( H_pCalEtotNorm    );
+  AddRandHist( H_pCalEtotTrkNorm );
+  AddRandHist( H_pHodBetaNtrk    );
+  AddRandHist( H_pHodBetaTrk     );
+  
+  AddRandHist( H_hcal_vs_hcer     );
+  AddRandHist( H_pcal_vs_phgcer   );
+  AddRandHist( H_pcal_vs_pngcer   );
+  AddRandHist( H_pngcer_vs_phgcer );
+
+  //KIN (primary)
+  AddRandHist( H_the     );
+  AddRandHist( H_kf      );
+  AddRandHist( H_W       );
+  AddRandHist( H_W2      );
+  AddRandHist( H_Q2      );
+  AddRandHist( H_xbj     );
+  AddRandHist( H_nu      );
+  AddRandHist( H_q       );
+  AddRandHist( H_qx      );
+  AddRandHist( H_qy      );
+  AddRandHist( H_qz      );
+  AddRandHist( H_thq     );
+  AddRandHist( H_phq     );
+  AddRandHist( H_epsilon );
+
+  //KIN (secondary)
+  AddRandHist( H_Em       );
+  AddRandHist( H_Em_nuc   );
+  AddRandHist( H_Em_src   );
+  AddRandHist( H_Pm       );
+  AddRandHist( H_Pmx_lab  );
+  AddRandHist( H_Pmy_lab  );
+  AddRandHist( H_Pmz_lab  );
+  AddRandHist( H_Pmx_q    );
+  AddRandHist( H_Pmy_q    );
+  AddRandHist( H_Pmz_q    );
+  AddRandHist( H_Tx       );
+  AddRandHist( H_Tr       );
+  AddRandHist( H_MM       );
+  AddRandHist( H_MM2      );
+  AddRandHist( H_thx      );
+  AddRandHist( H_Pf       );
+  AddRandHist( H_thxq     );
+  AddRandHist( H_thrq     );
+  AddRandHist( H_cthrq    );
+  AddRandHist( H_phxq     );
+  AddRandHist( H_phrq     );
+  AddRandHist( H_Tx_cm    );
+  AddRandHist( H_Tr_cm    );
+  AddRandHist( H_thxq_cm  );
+  AddRandHist( H_thrq_cm  );
+  AddRandHist( H_phxq_cm  );
+  AddRandHist( H_phrq_cm  );
+  AddRandHist( H_Ttot_cm  );
+  AddRandHist( H_MandelS  );
+  AddRandHist( H_MandelT  );
+  AddRandHist( H_MandelU  );
+
+  AddRandHist( H_cth_xq  );
+  AddRandHist( H_cth_rq  );
+  AddRandHist( H_sth_xq  );
+  AddRandHist( H_sth_rq  );
+  AddRandHist( H_cphi_xq );
+  AddRandHist( H_cphi_rq );
+  AddRandHist( H_sphi_xq );
+  AddRandHist( H_sphi_rq );
+
+  AddRandHist( H_cth_xq_cm  );
+  AddRandHist( H_cth_rq_cm  );
+  AddRandHist( H_sth_xq_cm  );
+  AddRandHist( H_sth_rq_cm  );
+  AddRandHist( H_cphi_xq_cm );
+  AddRandHist( H_cphi_rq_cm );
+  AddRandHist( H_sphi_xq_cm );
+  AddRandHist( H_sphi_rq_cm );
+
+  //ACCP
+  AddRandHist( H_exfp   );
+  AddRandHist( H_eyfp   );
+  AddRandHist( H_expfp  );
+  AddRandHist( H_eypfp  );
+
+  AddRandHist( H_eytar  );
+  AddRandHist( H_exptar );
+  AddRandHist( H_eyptar );
+  AddRandHist( H_edelta );
+
+  AddRandHist( H_hxfp   );
+  AddRandHist( H_hyfp   );
+  AddRandHist( H_hxpfp  );
+  AddRandHist( H_hypfp  );
+
+  AddRandHist( H_hytar  );
+  AddRandHist( H_hxptar );
+  AddRandHist( H_hyptar );
+  AddRandHist( H_hdelta );
+
+  AddRandHist( H_htar_x    );
+  AddRandHist( H_htar_y    );
+  AddRandHist( H_htar_z    );
+  AddRandHist( H_etar_x    );
+  AddRandHist( H_etar_y    );
+  AddRandHist( H_etar_z    );
+  AddRandHist( H_ztar_diff );
+
+  AddRandHist( H_hXColl );
+  AddRandHist( H_hYColl );
+  AddRandHist( H_eXColl );
+  AddRandHist( H_eYColl );
+
+  AddRandHist( H_hXColl_vs_hYColl );
+  AddRandHist( H_eXColl_vs_eYColl );
+
+  AddRandHist( H_hxfp_vs_hyfp );
+  AddRandHist( H_exfp_vs_eyfp );
 
 
   //-----------------------------------------------------
@@ -3350,15 +3415,28 @@ void baseAnalyzer::ReadScalerTree()
   cout << "Calling Base ReadScalerTree()  " << endl;
   cout << Form("Using %s ", bcm_type.Data()) << endl;
 
-  //Read ROOTfile
-  inROOT = new TFile(data_InputFileName.Data(), "READ");
+  //Read ROOTfile (re-opened every poll in follow mode, so close the previous handle)
+  delete inROOT_scaler;
+  inROOT_scaler = new TFile(data_InputFileName.Data(), "READ");
   
   
   //Get the SHMS scaler tree (HMS Scaler tree should be identical copy in coin mode. It is just used for cross check)
-  scaler_tree = (TTree*)inROOT->Get(scl_tree_name.Data());
+  scaler_tree = (TTree*)inROOT_scaler->Get(scl_tree_name.Data());
   scal_entries = scaler_tree->GetEntries();
-  evt_flag_bcm = new Int_t[scal_entries]; //store 0 or 1, to determine which scaler read passed cut
-  scal_evt_num = new Int_t[scal_entries]; //store event associated with scaler read
+
+  if(evt_flag_bcm==NULL){
+    evt_flag_bcm = new Int_t[scal_entries]; //store 0 or 1, to determine which scaler read passed cut
+    scal_evt_num = new Int_t[scal_entries]; //store event associated with scaler read
+    scal_slice   = new Int_t[scal_entries]; //store time slice associated with scaler read
+    scal_bcm_mask = new ULong64_t[scal_entries]; //store bcm scan points passed by scaler read
+  }
+  else{
+    //follow mode: keep the scaler reads already analyzed, and make room for the new ones
+    GrowArray(evt_flag_bcm,  scal_entries_done, scal_entries);
+    GrowArray(scal_evt_num,  scal_entries_done, scal_entries);
+    GrowArray(scal_slice,    scal_entries_done, scal_entries);
+    GrowArray(scal_bcm_mask, scal_entries_done, scal_entries);
+  }
   
   if(daq_mode=="coin")
     {
@@ -3436,11 +3514,23 @@ void baseAnalyzer::ScalerEventLoop()
   
   cout << "Calling Base ScalerEventLoop() " << endl;
 
-  
+  //follow mode: resuming from a previous poll, so undo the EDTM subtraction applied at the end of the previous call
+  if(scal_entries_done>0){
+    total_s1x_scaler_bcm_cut = total_s1x_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_s1y_scaler_bcm_cut = total_s1y_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_s2x_scaler_bcm_cut = total_s2x_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_s2y_scaler_bcm_cut = total_s2y_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig1_scaler_bcm_cut = total_trig1_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig2_scaler_bcm_cut = total_trig2_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig3_scaler_bcm_cut = total_trig3_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig4_scaler_bcm_cut = total_trig4_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig5_scaler_bcm_cut = total_trig5_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+    total_trig6_scaler_bcm_cut = total_trig6_scaler_bcm_cut + total_edtm_scaler_bcm_cut;
+  }
 
 
-  //Scaler reads loop. ith scaler read
-  for (int i = 0; i < scal_entries; i++) 
+  //Scaler reads loop. ith scaler read (starting from the first read not yet analyzed)
+  for (int i = scal_entries_done; i < scal_entries; i++) 
     {
       /*(NOTE: Each scaler read is associated with as specific event number
 	as (scaler read 1-> event 1000,  scaler read 2 -> event 2300, ...)
@@ -3450,6 +3540,7 @@ void baseAnalyzer::ScalerEventLoop()
       
       //Set Event Flag to FALSE (default)
       evt_flag_bcm[i] = 0;
+      scal_bcm_mask[i] = 0;
       
       //Store event associated with scaler read
       scal_evt_num[i] = Scal_evNum;
@@ -3457,18 +3548,23 @@ void baseAnalyzer::ScalerEventLoop()
       // Determine which bcm current to cut on (based on user input)
       if(bcm_type=="BCM1"){
 	Scal_BCM_current = Scal_BCM1_current;
+	Scal_BCM_charge  = Scal_BCM1_charge;
       }
       else if(bcm_type=="BCM2"){
 	Scal_BCM_current = Scal_BCM2_current;
+	Scal_BCM_charge  = Scal_BCM2_charge;
       }
       else if(bcm_type=="BCM4A"){
 	Scal_BCM_current = Scal_BCM4A_current;
+	Scal_BCM_charge  = Scal_BCM4A_charge;
       }
       else if(bcm_type=="BCM4B"){
 	Scal_BCM_current = Scal_BCM4B_current;
+	Scal_BCM_charge  = Scal_BCM4B_charge;
       }
       else if(bcm_type=="BCM4C"){
 	Scal_BCM_current = Scal_BCM4C_current;
+	Scal_BCM_charge  = Scal_BCM4C_charge;
       }
 
       //Store Cumulative Quantities
@@ -3490,6 +3586,15 @@ void baseAnalyzer::ScalerEventLoop()
       total_trig6_scaler = TRIG6_scaler;
       total_edtm_scaler = EDTM_scaler;
 
+      //Assign scaler read to a time slice: a new slice is started every scaler read,
+      //or once the current slice has reached the user-defined width (time_slice_width)
+      if(time_slice_flag){
+	if(nslices==0 || time_slice_width<=0. || (prev_time - ts_time_start[nslices-1]) >= time_slice_width){
+	  AddTimeSlice(prev_time);
+	}
+	scal_slice[i] = nslices-1;
+	ts_time_end[nslices-1] = Scal_time;
+      }
     
       //Check If BCM Beam Current in Between Reads is Over Threshold
       //set_current = 40.;
@@ -3519,10 +3624,50 @@ void baseAnalyzer::ScalerEventLoop()
 	  total_trig6_scaler_bcm_cut = total_trig6_scaler_bcm_cut + (TRIG6_scaler-prev_trig6_scaler);
 	  total_edtm_scaler_bcm_cut = total_edtm_scaler_bcm_cut + (EDTM_scaler - prev_edtm_scaler);
 
+	  //Store Quantities that Passed the Current Threshold (per time slice)
+	  if(time_slice_flag){
+	    Int_t is = scal_slice[i];
+	    ts_time_bcm_cut[is]        += (Scal_time - prev_time);
+	    ts_charge_bcm_cut[is]      += (Scal_BCM_charge - prev_charge_bcm);
+	    ts_trig_scaler_bcm_cut[0][is] += (TRIG1_scaler-prev_trig1_scaler);
+	    ts_trig_scaler_bcm_cut[1][is] += (TRIG2_scaler-prev_trig2_scaler);
+	    ts_trig_scaler_bcm_cut[2][is] += (TRIG3_scaler-prev_trig3_scaler);
+	    ts_trig_scaler_bcm_cut[3][is] += (TRIG4_scaler-prev_trig4_scaler);
+	    ts_trig_scaler_bcm_cut[4][is] += (TRIG5_scaler-prev_trig5_scaler);
+	    ts_trig_scaler_bcm_cut[5][is] += (TRIG6_scaler-prev_trig6_scaler);
+	    ts_edtm_scaler_bcm_cut[is] += (EDTM_scaler - prev_edtm_scaler);
+	  }
+	  
 	} //End BCM Current Cut
 
+      //Check each BCM scan point (BCM, threshold) and store quantities that passed it (see WriteBCMScan())
+      if(bcm_scan_flag){
+
+	Double_t scal_bcm_current[5] = {Scal_BCM1_current, Scal_BCM2_current, Scal_BCM4A_current, Scal_BCM4B_current, Scal_BCM4C_current};
+	Double_t scal_bcm_dcharge[5] = {Scal_BCM1_charge - prev_charge_bcm1, Scal_BCM2_charge - prev_charge_bcm2, Scal_BCM4A_charge - prev_charge_bcm4a,
+					Scal_BCM4B_charge - prev_charge_bcm4b, Scal_BCM4C_charge - prev_charge_bcm4c};
+	
+	for(int j=0; j<nscan; j++){
+
+	  if(scal_bcm_current[ bs_bcm_idx[j] ] <= bs_bcm_thrs[j]) continue;
+
+	  scal_bcm_mask[i] |= (1ULL << j);
+	  
+	  bs_time_bcm_cut[j]   += (Scal_time - prev_time);
+	  bs_charge_bcm_cut[j] += scal_bcm_dcharge[ bs_bcm_idx[j] ];
+	  bs_trig_scaler_bcm_cut[0][j] += (TRIG1_scaler-prev_trig1_scaler);
+	  bs_trig_scaler_bcm_cut[1][j] += (TRIG2_scaler-prev_trig2_scaler);
+	  bs_trig_scaler_bcm_cut[2][j] += (TRIG3_scaler-prev_trig3_scaler);
+	  bs_trig_scaler_bcm_cut[3][j] += (TRIG4_scaler-prev_trig4_scaler);
+	  bs_trig_scaler_bcm_cut[4][j] += (TRIG5_scaler-prev_trig5_scaler);
+	  bs_trig_scaler_bcm_cut[5][j] += (TRIG6_scaler-prev_trig6_scaler);
+	  bs_edtm_scaler_bcm_cut[j] += (EDTM_scaler - prev_edtm_scaler);
+	}
+      }
+
       //Previous Scaler Reads (Necessary to Take Average between S-1 and S scaler reads, to get values in between)
       prev_time = Scal_time;
+      prev_charge_bcm  = Scal_BCM_charge;
       prev_charge_bcm1 = Scal_BCM1_charge;
       prev_charge_bcm2 = Scal_BCM2_charge;
       prev_charge_bcm4a = Scal_BCM4A_charge;
@@ -3547,6 +3692,8 @@ void baseAnalyzer::ScalerEventLoop()
     
     } //End Scaler Read Loop
 
+  scal_entries_done = scal_entries;
+  
   // Set generic bcm info to be used in charge normalization based on user input
   if(bcm_type=="BCM1"){
     total_charge_bcm     = total_charge_bcm1;
@@ -3599,6 +3746,112 @@ void baseAnalyzer::ScalerEventLoop()
   
 }
 
+//_______________________________________________________________________________
+void baseAnalyzer::AddTimeSlice(Double_t t_start)
+{
+  // Brief: Start a new (empty) time slice at run time t_start [sec] (see ScalerEventLoop())
+
+  nslices++;
+
+  ts_time_start.push_back(t_start);
+  ts_time_end.push_back(t_start);
+  ts_time_bcm_cut.push_back(0.);
+  ts_charge_bcm_cut.push_back(0.);
+  for(int itrg=0; itrg<6; itrg++){
+    ts_trig_scaler_bcm_cut[itrg].push_back(0.);
+    ts_trig_accp_bcm_cut[itrg].push_back(0.);
+  }
+  ts_edtm_scaler_bcm_cut.push_back(0.);
+  ts_edtm_accp_bcm_cut.push_back(0.);
+  ts_trig2_singles_accp.push_back(0.);
+  ts_h_did.push_back(0.);
+  ts_h_should.push_back(0.);
+  ts_p_did.push_back(0.);
+  ts_p_should.push_back(0.);
+  ts_yield_total.push_back(0.);
+  ts_yield_rand.push_back(0.);
+  
+}
+
+//_______________________________________________________________________________
+void baseAnalyzer::SetBCMScan(string bcm_list, string thrs_list)
+{
+  // Brief: Set up the BCM scan points (every BCM in bcm_list x every threshold [uA] in thrs_list, comma-separated)
+  //        and the per-scan-point counters (see ScalerEventLoop(), EventLoop(), WriteBCMScan())
+
+  const TString bcm_names[5] = {"BCM1", "BCM2", "BCM4A", "BCM4B", "BCM4C"};
+  
+  vector<string> bcm_parsed  = parse_line(bcm_list, ',');
+  vector<string> thrs_parsed = parse_line(thrs_list, ',');
+
+  nscan = 0;
+  
+  for(int ib=0; ib<bcm_parsed.size(); ib++){
+
+    string bcm_name = trim(bcm_parsed[ib]);
+    if(bcm_name.empty()) continue;
+
+    //Find BCM index
+    Int_t idx = -1;
+    for(int k=0; k<5; k++){ if(bcm_names[k]==bcm_name.c_str()) { idx = k; } }
+    
+    if(idx<0){
+      cout << Form("BCM SCAN ERROR: %s is NOT a valid BCM (BCM1, BCM2, BCM4A, BCM4B, BCM4C) ! ! !", bcm_name.c_str()) << endl;
+      cout << "Exiting NOW !" << endl;
+      gSystem->Exit(0);
+    }
+    
+    for(int it=0; it<thrs_parsed.size(); it++){
+
+      string thrs_val = trim(thrs_parsed[it]);
+      if(thrs_val.empty()) continue;
+
+      if(nscan==nscan_max){
+	cout << Form("BCM SCAN ERROR: too many scan points (max. %d = n_bcm x n_thrs) ! ! !", nscan_max) << endl;
+	cout << "Exiting NOW !" << endl;
+	gSystem->Exit(0);
+      }
+      
+      nscan++;
+
+      bs_bcm_type.push_back(bcm_names[idx]);
+      bs_bcm_idx.push_back(idx);
+      bs_bcm_thrs.push_back(stod(thrs_val));
+      
+      bs_time_bcm_cut.push_back(0.);
+      bs_charge_bcm_cut.push_back(0.);
+      for(int itrg=0; itrg<6; itrg++){
+	bs_trig_scaler_bcm_cut[itrg].push_back(0.);
+	bs_trig_accp_bcm_cut[itrg].push_back(0.);
+      }
+      bs_edtm_scaler_bcm_cut.push_back(0.);
+      bs_edtm_accp_bcm_cut.push_back(0.);
+      bs_h_did.push_back(0.);
+      bs_h_should.push_back(0.);
+      bs_p_did.push_back(0.);
+      bs_p_should.push_back(0.);
+      bs_yield_total.push_back(0.);
+      bs_yield_rand.push_back(0.);
+    }
+  }
+
+  cout << Form("BCM scan: %d scan points (%d BCMs x %d thresholds)", nscan, (int)bcm_parsed.size(), (int)thrs_parsed.size()) << endl;
+  
+}
+
+//_______________________________________________________________________________
+template<class T> void baseAnalyzer::GrowArray(T *&arr, Long64_t n_old, Long64_t n_new)
+{
+  // Brief: Re-allocate a scaler read array to n_new elements, keeping its first n_old elements (follow mode)
+
+  T *tmp = new T[n_new];
+  for(Long64_t i=0; i<n_old && i<n_new; i++){ tmp[i] = arr[i]; }
+
+  delete [] arr;
+  arr = tmp;
+  
+}
+
 //__________________________________________________________________________
 void baseAnalyzer::CreateSinglesSkimTree()
 {
@@ -3936,7 +4189,8 @@ void baseAnalyzer::ReadTree()
       
       cout << "Reading DATA Tree . . . " << endl;
       
-      //Read ROOTfile
+      //Read ROOTfile (re-opened every poll in follow mode, so close the previous handle)
+      delete inROOT;
       inROOT = new TFile(data_InputFileName.Data(), "READ");
       
       //Get the data tree
@@ -4277,11 +4531,11 @@ void baseAnalyzer::ReadTree()
 	  
 	}
       
-      // Call function to create skimmed version of data tree
-      CreateSkimTree();
+      // Call function to create skimmed version of data tree (only once, in follow mode)
+      if(tree_skim==NULL) CreateSkimTree();
       
       // Call function to create singles skimmed version of data tree
-      CreateSinglesSkimTree();
+      if(tree_skim_singles==NULL) CreateSinglesSkimTree();
       
       
     } //END DATA SET BRANCH ADDRESS
@@ -4681,8 +4935,8 @@ void baseAnalyzer::EventLoop()
   gROOT->SetBatch(1);
   cout << "Calling Base EventLoop() . . . " << endl;
 
-  //Call Method to Set Collimator Graphical Cuts (In case it is used)
-  CollimatorStudy();
+  //Call Method to Set Collimator Graphical Cuts (In case it is used) -- only in the 1st poll of follow mode
+  if(follow_npoll==0) CollimatorStudy();
   
   //Loop over Events
   
@@ -4690,13 +4944,17 @@ void baseAnalyzer::EventLoop()
     {
 
       
-      // Get Coin. Time peak, beta peak, calorimeter peak, and dc residuals peak fit
-      GetPeak();
+      // Get Coin. Time peak, beta peak, calorimeter peak, and dc residuals peak fit (the peaks are kept for all polls in follow mode)
+      if(follow_npoll==0) GetPeak();
 
-      cout << "Analyzing DATA Events | nentries -->  " << nentries << endl;
+      cout << "Analyzing DATA Events | nentries -->  " << nentries << " (starting from entry " << ientry_done << ")" << endl;
 
-      for(int ientry=0; ientry<nentries; ientry++)
+      Long64_t ientry;
+      for(ientry=ientry_done; ientry<nentries; ientry++)
 	{
+
+	  //follow mode: stop at the first event whose scaler read is not in the ROOTfile yet (resumed in the next poll)
+	  if(follow_flag && scal_read>=scal_entries) break;
 	  
 	  tree->GetEntry(ientry);
 
@@ -5084,6 +5342,18 @@ void baseAnalyzer::EventLoop()
 	      if(c_trig4 && c_noedtm) { total_trig4_accp_bcm_cut++; }
 	      if(c_trig5 && c_noedtm) { total_trig5_accp_bcm_cut++; }
 	      if(c_trig6 && c_noedtm) { total_trig6_accp_bcm_cut++; }
+
+	      //Count Accepted EDTM / TRIG1-6 events per time slice (see WriteTimeSlices())
+	      if(time_slice_flag){
+		islice = scal_slice[scal_read];
+		if(c_edtm) { ts_edtm_accp_bcm_cut[islice]++; }
+		if(c_trig1 && c_noedtm) { ts_trig_accp_bcm_cut[0][islice]++; }
+		if(c_trig2 && c_noedtm) { ts_trig_accp_bcm_cut[1][islice]++; }
+		if(c_trig3 && c_noedtm) { ts_trig_accp_bcm_cut[2][islice]++; }
+		if(c_trig4 && c_noedtm) { ts_trig_accp_bcm_cut[3][islice]++; }
+		if(c_trig5 && c_noedtm) { ts_trig_accp_bcm_cut[4][islice]++; }
+		if(c_trig6 && c_noedtm) { ts_trig_accp_bcm_cut[5][islice]++; }
+	      }
 	      
 	      // Count SHMS Singles ONLY (particularly, only count T1 and T2)
 
@@ -5105,6 +5375,7 @@ void baseAnalyzer::EventLoop()
 		  
 		  // count T2 accepted singles
 		  total_trig2_singles_accp++;
+		  if(time_slice_flag) { ts_trig2_singles_accp[islice]++; }
 		}
 
 		
@@ -5141,6 +5412,14 @@ void baseAnalyzer::EventLoop()
 		  if(good_shms_did){ p_did++;}
 		  if(good_shms_should){ p_should++; }
 
+		  //Tracking Efficiency Components per time slice
+		  if(time_slice_flag){
+		    if(good_hms_did)    { ts_h_did[islice]++; }
+		    if(good_hms_should) { ts_h_should[islice]++; }
+		    if(good_shms_did)   { ts_p_did[islice]++; }
+		    if(good_shms_should){ ts_p_should[islice]++; }
+		  }
+
 		  
 		  //----------------------Fill DATA Histograms-----------------------
 
@@ -5553,183 +5832,22 @@ void baseAnalyzer::EventLoop()
 		  
 		    
 		    // select "TRUE COINCIDENCE " (electron-proton from same "beam bunch" form a coincidence)
-		    if(eP_ctime_cut)
-		      {
-			
-			//--------------------------------------------------------------------
-			//---------HISTOGRAM CATEGORY: Particle Identification (PID)----------
-			//--------------------------------------------------------------------
-			
-			//Coincidence Time		      
-			H_ep_ctime_real->Fill(epCoinTime-ctime_offset_peak_val); // fill coin. time and apply the offset
-			
-			//Fill HMS Detectors
-			H_hCerNpeSum->Fill(hcer_npesum);
-			H_hCalEtotNorm->Fill(hcal_etotnorm);
-			H_hCalEtotTrkNorm->Fill(hcal_etottracknorm);
-			H_hHodBetaNtrk->Fill(hhod_beta_ntrk);
-			H_hHodBetaTrk->Fill(hhod_beta);
-			
-			//Fill SHMS Detectors
-			H_pNGCerNpeSum->Fill(pngcer_npesum);
-			H_pHGCerNpeSum->Fill(phgcer_npesum);
-			H_pCalEtotNorm->Fill(pcal_etotnorm);
-			H_pCalEtotTrkNorm->Fill(pcal_etottracknorm);
-			H_pHodBetaNtrk->Fill(phod_beta_ntrk);
-			H_pHodBetaTrk->Fill(phod_beta);
-			
-			//Fill 2D PID Correlations
-			H_hcal_vs_hcer->Fill(hcal_etottracknorm, hcer_npesum);
-			H_pcal_vs_phgcer->Fill(pcal_etottracknorm, phgcer_npesum);  
-			H_pcal_vs_pngcer->Fill(pcal_etottracknorm, pngcer_npesum);   
-			H_pngcer_vs_phgcer->Fill(pngcer_npesum, phgcer_npesum);
-			
-			
-			
-			//--------------------------------------------------------
-			//---------HISTOGRAM CATEGORY: Kinematics  (KIN)----------
-			//--------------------------------------------------------
-			
-			//Fill Primary Kin Histos
-			H_the    ->Fill(th_e/dtr);
-			H_kf     ->Fill(kf);
-			H_W      ->Fill(W);
-			H_W2     ->Fill(W2);
-			H_Q2     ->Fill(Q2);
-			H_xbj    ->Fill(X);
-			H_nu     ->Fill(nu);
-			H_q      ->Fill(q);
-			H_qx     ->Fill(qx);
-			H_qy     ->Fill(qy);
-			H_qz     ->Fill(qz);
-			H_thq    ->Fill(th_q/dtr);
-			H_phq    ->Fill(ph_q/dtr);
-			H_epsilon->Fill(epsilon); 
-			
-			//Fill Secondary Kin Histos
-			H_Em       ->Fill(Em);
-			H_Em_nuc   ->Fill(Em_nuc);
-			H_Em_src   ->Fill(Em_src);
-			H_Pm       ->Fill(Pm);
-			H_Pmx_lab  ->Fill(Pmx_lab);
-			H_Pmy_lab  ->Fill(Pmy_lab);
-			H_Pmz_lab  ->Fill(Pmz_lab);
-			H_Pmx_q    ->Fill(Pmx_q);
-			H_Pmy_q    ->Fill(Pmy_q);
-			H_Pmz_q    ->Fill(Pmz_q);
-			H_Tx       ->Fill(Tx);
-			H_Tr       ->Fill(Tr);
-			H_MM       ->Fill(MM);
-			H_MM2      ->Fill(MM2);
-			H_thx      ->Fill(th_x/dtr);
-			H_Pf       ->Fill(Pf);
-			H_thxq     ->Fill(th_xq/dtr);
-			H_thrq     ->Fill(th_rq/dtr);
-			H_cthrq    ->Fill( cos(th_rq) );
-			H_phxq     ->Fill(ph_xq/dtr);
-			H_phrq     ->Fill(ph_rq/dtr);
-			H_Tx_cm    ->Fill(Tx_cm);
-			H_Tr_cm    ->Fill(Tr_cm);
-			H_thxq_cm  ->Fill(th_xq_cm/dtr);
-			H_thrq_cm  ->Fill(th_rq_cm/dtr);
-			H_phxq_cm  ->Fill(ph_xq_cm/dtr);
-			H_phrq_cm  ->Fill(ph_rq_cm/dtr);
-			H_Ttot_cm  ->Fill(Ttot_cm);
-			H_MandelS  ->Fill(MandelS);
-			H_MandelT  ->Fill(MandelT);
-			H_MandelU  ->Fill(MandelU);
-			
-			//Fill (cosine, sine) of angles relative to q		      
-			H_cth_xq  ->Fill(cos(th_xq));
-			H_cth_rq  ->Fill(cos(th_rq));
-			H_sth_xq  ->Fill(sin(th_xq));
-			H_sth_rq  ->Fill(sin(th_rq));
-			H_cphi_xq ->Fill(cos(ph_xq));
-			H_cphi_rq ->Fill(cos(ph_rq));
-			H_sphi_xq ->Fill(sin(ph_xq));
-			H_sphi_rq ->Fill(sin(ph_rq));
-			//CM Frame
-			H_cth_xq_cm  ->Fill(cos(th_xq_cm));
-			H_cth_rq_cm  ->Fill(cos(th_rq_cm));
-			H_sth_xq_cm  ->Fill(sin(th_xq_cm));
-			H_sth_rq_cm  ->Fill(sin(th_rq_cm));
-			H_cphi_xq_cm ->Fill(cos(ph_xq_cm));
-			H_cphi_rq_cm ->Fill(cos(ph_rq_cm));
-			H_sphi_xq_cm ->Fill(sin(ph_xq_cm));
-			H_sphi_rq_cm ->Fill(sin(ph_rq_cm));
-			
-
-			
-			//----------------------------------------------------------------------
-			//---------HISTOGRAM CATEGORY: Spectrometer Acceptance  (ACCP)----------
-			//----------------------------------------------------------------------
-			//Fill SPECTROMETER  ACCEPTANCE
-			H_exfp       ->Fill(e_xfp);
-			H_eyfp       ->Fill(e_yfp);
-			H_expfp      ->Fill(e_xpfp);
-			H_eypfp      ->Fill(e_ypfp);
-			
-			H_eytar      ->Fill(e_ytar);
-			H_exptar     ->Fill(e_xptar);
-			H_eyptar     ->Fill(e_yptar);
-			H_edelta     ->Fill(e_delta);
-			
-			H_hxfp       ->Fill(h_xfp);
-			H_hyfp       ->Fill(h_yfp);
-			H_hxpfp      ->Fill(h_xpfp);
-			H_hypfp      ->Fill(h_ypfp);
-			
-			H_hytar       ->Fill(h_ytar);
-			H_hxptar      ->Fill(h_xptar);
-			H_hyptar      ->Fill(h_yptar);
-			H_hdelta      ->Fill(h_delta);
-			
-			H_htar_x       ->Fill(htar_x);
-			H_htar_y       ->Fill(htar_y);
-			H_htar_z       ->Fill(htar_z);
-			H_etar_x       ->Fill(etar_x);
-			H_etar_y       ->Fill(etar_y);
-			H_etar_z       ->Fill(etar_z);
-			H_ztar_diff    ->Fill(ztar_diff);
-			
-			H_hXColl      ->Fill(hXColl);
-			H_hYColl      ->Fill(hYColl);
-			H_eXColl      ->Fill(eXColl);
-			H_eYColl      ->Fill(eYColl);
-			
-			H_hXColl_vs_hYColl  ->Fill(hYColl, hXColl);
-			H_eXColl_vs_eYColl  ->Fill(eYColl, eXColl);
-			
-			H_hxfp_vs_hyfp  ->Fill(h_yfp, h_xfp);
-			H_exfp_vs_eyfp  ->Fill(e_yfp, e_xfp);
-			
-			
-		      } // end TRUE COINCIDENCE time cut
-
+		    if(eP_ctime_cut) {
+		      FillCoinHistos();
+		      if(time_slice_flag) { ts_yield_total[islice]++; }
+		    }
 		    
 		    
 		    // select "ACCIDENTAL COINCIDENCE BACKGROUND" left/right of main coin. peak as a sample to estimate background underneath main coin. peak
 		    // background underneath main peak: electron-proton from same "beam bunch" form a random ("un-correlated") coincidence
-
+		    // (the same histograms are filled, but redirected to their *_rand twins, see AddRandHist())
 		    if(ePctime_cut_flag && eP_ctime_cut_rand)
-		      
 		      {
-			// Only histograms of selected variables of interest will be filled with coincidence accidantal background (for background subtraction)
-			
-			H_ep_ctime_rand->  Fill ( epCoinTime-ctime_offset_peak_val );
-			H_W_rand       ->  Fill (W);       
-			H_Q2_rand      ->  Fill (Q2);      
-			H_xbj_rand     ->  Fill (X);     
-			H_nu_rand      ->  Fill (nu);      
-			H_q_rand       ->  Fill (q);       
-			H_Em_rand      ->  Fill (Em);      
-			H_Em_nuc_rand  ->  Fill (Em_nuc);  
-			H_Pm_rand      ->  Fill (Pm);      
-			H_MM_rand      ->  Fill (MM);      
-			H_thxq_rand    ->  Fill (th_xq/dtr);    
-			H_thrq_rand    ->  Fill (ph_xq/dtr);    
-				       	
-		      }  		    		   
+			SetRandFill(kTRUE);
+			FillCoinHistos();
+			SetRandFill(kFALSE);
+			if(time_slice_flag) { ts_yield_rand[islice]++; }
+		      }
 		    
 
 
@@ -5743,6 +5861,36 @@ void baseAnalyzer::EventLoop()
 	      
 	    }  //-----END: BCM Current Cut------
 
+
+	  //----------------------Count Normalization / Yield for each BCM scan point (see WriteBCMScan())---------------------
+	  // (the scan points are independent of the nominal bcm cut above, so they are evaluated for every event)
+	  if(bcm_scan_flag && scal_bcm_mask[scal_read]!=0){
+
+	    Bool_t c_trig_noedtm[6] = {c_trig1 && c_noedtm, c_trig2 && c_noedtm, c_trig3 && c_noedtm,
+				       c_trig4 && c_noedtm, c_trig5 && c_noedtm, c_trig6 && c_noedtm};
+	    Bool_t c_yield_base = c_noedtm && c_baseCuts && pdc_TheRealGolden==1 && gevtyp==4;
+	    Bool_t c_yield_real = c_yield_base && eP_ctime_cut;
+	    Bool_t c_yield_rand = c_yield_base && ePctime_cut_flag && eP_ctime_cut_rand;
+	    
+	    for(int j=0; j<nscan; j++){
+
+	      if( !(scal_bcm_mask[scal_read] & (1ULL << j)) ) continue;
+
+	      if(c_edtm) { bs_edtm_accp_bcm_cut[j]++; }
+	      for(int itrg=0; itrg<6; itrg++){ if(c_trig_noedtm[itrg]) { bs_trig_accp_bcm_cut[itrg][j]++; } }
+
+	      if(c_noedtm){
+		if(good_hms_did)    { bs_h_did[j]++; }
+		if(good_hms_should) { bs_h_should[j]++; }
+		if(good_shms_did)   { bs_p_did[j]++; }
+		if(good_shms_should){ bs_p_should[j]++; }
+	      }
+
+	      if(c_yield_real) { bs_yield_total[j]++; }
+	      if(c_yield_rand) { bs_yield_rand[j]++; }
+	    }
+	  }
+
 	  
 	  
 	  
@@ -5764,6 +5912,8 @@ void baseAnalyzer::EventLoop()
 
 	}//END DATA EVENT LOOP
 
+      ientry_done = ientry;
+      
 
       // Get data E/p multi-peak information (# events with multipeak E/p, those events thrown away in by pid cut E/p> (E/p)_max, and # events with single peak)
       total_bins = H_multitrack_pCalEtotNorm_peak1->GetNbinsX();
@@ -5773,13 +5923,17 @@ void baseAnalyzer::EventLoop()
       multi_track_eff_err     = sqrt( pow(multi_track_eff,2) * ( pow(single_peak_counts_err/single_peak_counts,2) + pow(multi_peak_counts_err/multi_peak_counts,2) ) );
 
 
-      //Save Singles Skimmed Tree
-      tree_skim_singles->SaveAs( data_OutputFileName_skim_singles.Data() );
-      delete tree_skim_singles;
-      
-      //Save Skimmed Tree
-      tree_skim->SaveAs( data_OutputFileName_skim.Data() );
-      delete tree_skim;
+      //Save Skimmed Trees (follow mode: only once the run has finished)
+      if(!follow_flag || follow_last_poll){
+	
+	//Save Singles Skimmed Tree
+	tree_skim_singles->SaveAs( data_OutputFileName_skim_singles.Data() );
+	delete tree_skim_singles;
+	
+	//Save Skimmed Tree
+	tree_skim->SaveAs( data_OutputFileName_skim.Data() );
+	delete tree_skim;
+      }
 
     }//END DATA ANALYSIS
 
@@ -6123,6 +6277,218 @@ void baseAnalyzer::EventLoop()
   
 }
 
+//_______________________________________________________________________________
+void baseAnalyzer::FillCoinHistos()
+{
+  /*
+    Brief: Fill the (unweighted) data histograms of selected coincidences. It is called once for the
+    main coin. peak selection and once for the accidentals selection, in which case the registered
+    histograms (see AddRandHist()) are redirected to their *_rand twins by SetRandFill()
+  */
+
+  //--------------------------------------------------------------------
+  //---------HISTOGRAM CATEGORY: Particle Identification (PID)----------
+  //--------------------------------------------------------------------
+
+  //Coincidence Time		      
+  H_ep_ctime_real->Fill(epCoinTime-ctime_offset_peak_val); // fill coin. time and apply the offset
+
+  //Fill HMS Detectors
+  H_hCerNpeSum->Fill(hcer_npesum);
+  H_hCalEtotNorm->Fill(hcal_etotnorm);
+  H_hCalEtotTrkNorm->Fill(hcal_etottracknorm);
+  H_hHodBetaNtrk->Fill(hhod_beta_ntrk);
+  H_hHodBetaTrk->Fill(hhod_beta);
+
+  //Fill SHMS Detectors
+  H_pNGCerNpeSum->Fill(pngcer_npesum);
+  H_pHGCerNpeSum->Fill(phgcer_npesum);
+  H_pCalEtotNorm->Fill(pcal_etotnorm);
+  H_pCalEtotTrkNorm->Fill(pcal_etottracknorm);
+  H_pHodBetaNtrk->Fill(phod_beta_ntrk);
+  H_pHodBetaTrk->Fill(phod_beta);
+
+  //Fill 2D PID Correlations
+  H_hcal_vs_hcer->Fill(hcal_etottracknorm, hcer_npesum);
+  H_pcal_vs_phgcer->Fill(pcal_etottracknorm, phgcer_npesum);  
+  H_pcal_vs_pngcer->Fill(pcal_etottracknorm, pngcer_npesum);   
+  H_pngcer_vs_phgcer->Fill(pngcer_npesum, phgcer_npesum);
+
+
+
+  //--------------------------------------------------------
+  //---------HISTOGRAM CATEGORY: Kinematics  (KIN)----------
+  //--------------------------------------------------------
+
+  //Fill Primary Kin Histos
+  H_the    ->Fill(th_e/dtr);
+  H_kf     ->Fill(kf);
+  H_W      ->Fill(W);
+  H_W2     ->Fill(W2);
+  H_Q2     ->Fill(Q2);
+  H_xbj    ->Fill(X);
+  H_nu     ->Fill(nu);
+  H_q      ->Fill(q);
+  H_qx     ->Fill(qx);
+  H_qy     ->Fill(qy);
+  H_qz     ->Fill(qz);
+  H_thq    ->Fill(th_q/dtr);
+  H_phq    ->Fill(ph_q/dtr);
+  H_epsilon->Fill(epsilon); 
+
+  //Fill Secondary Kin Histos
+  H_Em       ->Fill(Em);
+  H_Em_nuc   ->Fill(Em_nuc);
+  H_Em_src   ->Fill(Em_src);
+  H_Pm       ->Fill(Pm);
+  H_Pmx_lab  ->Fill(Pmx_lab);
+  H_Pmy_lab  ->Fill(Pmy_lab);
+  H_Pmz_lab  ->Fill(Pmz_lab);
+  H_Pmx_q    ->Fill(Pmx_q);
+  H_Pmy_q    ->Fill(Pmy_q);
+  H_Pmz_q    ->Fill(Pmz_q);
+  H_Tx       ->Fill(Tx);
+  H_Tr       ->Fill(Tr);
+  H_MM       ->Fill(MM);
+  H_MM2      ->Fill(MM2);
+  H_thx      ->Fill(th_x/dtr);
+  H_Pf       ->Fill(Pf);
+  H_thxq     ->Fill(th_xq/dtr);
+  H_thrq     ->Fill(th_rq/dtr);
+  H_cthrq    ->Fill( cos(th_rq) );
+  H_phxq     ->Fill(ph_xq/dtr);
+  H_phrq     ->Fill(ph_rq/dtr);
+  H_Tx_cm    ->Fill(Tx_cm);
+  H_Tr_cm    ->Fill(Tr_cm);
+  H_thxq_cm  ->Fill(th_xq_cm/dtr);
+  H_thrq_cm  ->Fill(th_rq_cm/dtr);
+  H_phxq_cm  ->Fill(ph_xq_cm/dtr);
+  H_phrq_cm  ->Fill(ph_rq_cm/dtr);
+  H_Ttot_cm  ->Fill(Ttot_cm);
+  H_MandelS  ->Fill(MandelS);
+  H_MandelT  ->Fill(MandelT);
+  H_MandelU  ->Fill(MandelU);
+
+  //Fill (cosine, sine) of angles relative to q		      
+  H_cth_xq  ->Fill(cos(th_xq));
+  H_cth_rq  ->Fill(cos(th_rq));
+  H_sth_xq  ->Fill(sin(th_xq));
+  H_sth_rq  ->Fill(sin(th_rq));
+  H_cphi_xq ->Fill(cos(ph_xq));
+  H_cphi_rq ->Fill(cos(ph_rq));
+  H_sphi_xq ->Fill(sin(ph_xq));
+  H_sphi_rq ->Fill(sin(ph_rq));
+  //CM Frame
+  H_cth_xq_cm  ->Fill(cos(th_xq_cm));
+  H_cth_rq_cm  ->Fill(cos(th_rq_cm));
+  H_sth_xq_cm  ->Fill(sin(th_xq_cm));
+  H_sth_rq_cm  ->Fill(sin(th_rq_cm));
+  H_cphi_xq_cm ->Fill(cos(ph_xq_cm));
+  H_cphi_rq_cm ->Fill(cos(ph_rq_cm));
+  H_sphi_xq_cm ->Fill(sin(ph_xq_cm));
+  H_sphi_rq_cm ->Fill(sin(ph_rq_cm));
+
+
+
+  //----------------------------------------------------------------------
+  //---------HISTOGRAM CATEGORY: Spectrometer Acceptance  (ACCP)----------
+  //----------------------------------------------------------------------
+  //Fill SPECTROMETER  ACCEPTANCE
+  H_exfp       ->Fill(e_xfp);
+  H_eyfp       ->Fill(e_yfp);
+  H_expfp      ->Fill(e_xpfp);
+  H_eypfp      ->Fill(e_ypfp);
+
+  H_eytar      ->Fill(e_ytar);
+  H_exptar     ->Fill(e_xptar);
+  H_eyptar     ->Fill(e_yptar);
+  H_edelta     ->Fill(e_delta);
+
+  H_hxfp       ->Fill(h_xfp);
+  H_hyfp       ->Fill(h_yfp);
+  H_hxpfp      ->Fill(h_xpfp);
+  H_hypfp      ->Fill(h_ypfp);
+
+  H_hytar       ->Fill(h_ytar);
+  H_hxptar      ->Fill(h_xptar);
+  H_hyptar      ->Fill(h_yptar);
+  H_hdelta      ->Fill(h_delta);
+
+  H_htar_x       ->Fill(htar_x);
+  H_htar_y       ->Fill(htar_y);
+  H_htar_z       ->Fill(htar_z);
+  H_etar_x       ->Fill(etar_x);
+  H_etar_y       ->Fill(etar_y);
+  H_etar_z       ->Fill(etar_z);
+  H_ztar_diff    ->Fill(ztar_diff);
+
+  H_hXColl      ->Fill(hXColl);
+  H_hYColl      ->Fill(hYColl);
+  H_eXColl      ->Fill(eXColl);
+  H_eYColl      ->Fill(eYColl);
+
+  H_hXColl_vs_hYColl  ->Fill(hYColl, hXColl);
+  H_eXColl_vs_eYColl  ->Fill(eYColl, eXColl);
+
+  H_hxfp_vs_hyfp  ->Fill(h_yfp, h_xfp);
+  H_exfp_vs_eyfp  ->Fill(e_yfp, e_xfp);
+
+}
+
+//_______________________________________________________________________________
+void baseAnalyzer::AddRandHist(TH1F *&h_real)
+{
+  /*
+    Brief: Register a histogram filled in FillCoinHistos() for random coincidence background subtraction.
+    Two empty clones are created: <name>_rand (accidentals sample, stored in rand_HList) and
+    <name>_rand_sub (random-subtracted, stored in randSub_HList). A trailing "_real" is dropped
+    from the name, i.e., H_ep_ctime_real -> H_ep_ctime_rand, H_ep_ctime_rand_sub
+  */
+  
+  TString base_name = h_real->GetName();
+  if(base_name.EndsWith("_real")) { base_name.Resize(base_name.Length()-5); }
+
+  RandHist<TH1F> rh;
+  rh.slot = &h_real;
+  rh.real = h_real;
+  rh.rand = (TH1F*)h_real->Clone(base_name + "_rand");     rh.rand->Reset();
+  rh.sub  = (TH1F*)h_real->Clone(base_name + "_rand_sub"); rh.sub->Reset();
+
+  rand_HList->Add( rh.rand );
+  randSub_HList->Add( rh.sub );
+  
+  rand_H1.push_back(rh);
+}
+
+//_______________________________________________________________________________
+void baseAnalyzer::AddRandHist(TH2F *&h_real)
+{
+  // Brief: same as AddRandHist(TH1F *&h_real), for 2D histograms
+  
+  TString base_name = h_real->GetName();
+  if(base_name.EndsWith("_real")) { base_name.Resize(base_name.Length()-5); }
+
+  RandHist<TH2F> rh;
+  rh.slot = &h_real;
+  rh.real = h_real;
+  rh.rand = (TH2F*)h_real->Clone(base_name + "_rand");     rh.rand->Reset();
+  rh.sub  = (TH2F*)h_real->Clone(base_name + "_rand_sub"); rh.sub->Reset();
+
+  rand_HList->Add( rh.rand );
+  randSub_HList->Add( rh.sub );
+  
+  rand_H2.push_back(rh);
+}
+
+//_______________________________________________________________________________
+void baseAnalyzer::SetRandFill(Bool_t rand_flag)
+{
+  // Brief: point every registered member histogram to its *_rand twin (rand_flag=1) or back to the reals (rand_flag=0)
+  
+  for(unsigned int i=0; i<rand_H1.size(); i++) { *rand_H1[i].slot = rand_flag ? rand_H1[i].rand : rand_H1[i].real; }
+  for(unsigned int i=0; i<rand_H2.size(); i++) { *rand_H2[i].slot = rand_flag ? rand_H2[i].rand : rand_H2[i].real; }
+}
+
 //_______________________________________________________________________________
 void baseAnalyzer::RandSub()
 {
@@ -6131,7 +6497,7 @@ void baseAnalyzer::RandSub()
   
   /*
     Brief: This methods carries out the subtraction of random coincidences (outside coin peak selection) 
-    from real coincidences (within coin peak selected) for various histograms 
+    from real coincidences (within coin peak selected) for every histogram registered with AddRandHist()
   */
 
   // Scale Down (If necessary) the randoms before subtracting it from the total to get the real coincidences
@@ -6155,71 +6521,55 @@ void baseAnalyzer::RandSub()
   // if doing heep singles, scale randoms to zero (even though we take singles, there may still be events that sneak into the coin histograms)
   if(analysis_cut=="heep_singles") {P_scale_factor = 0;}
      
-  //----Scale Down the random coincidences histograms-----
-  H_ep_ctime_rand ->  Scale( P_scale_factor );
-  H_W_rand        ->  Scale( P_scale_factor );
-  H_Q2_rand       ->  Scale( P_scale_factor );
-  H_xbj_rand      ->  Scale( P_scale_factor );
-  H_nu_rand       ->  Scale( P_scale_factor );
-  H_q_rand        ->  Scale( P_scale_factor );
-  H_Em_rand       ->  Scale( P_scale_factor );
-  H_Em_nuc_rand   ->  Scale( P_scale_factor );
-  H_Pm_rand       ->  Scale( P_scale_factor );
-  H_MM_rand       ->  Scale( P_scale_factor );
-  H_thxq_rand     ->  Scale( P_scale_factor );
-  H_thrq_rand     ->  Scale( P_scale_factor );
-
-  
-  // -----Carry out the randoms subtraction------
-  H_ep_ctime_rand_sub ->Add(H_ep_ctime_real  ,H_ep_ctime_rand , 1, -1);
-  H_W_rand_sub       -> Add(H_W         ,H_W_rand        , 1, -1);
-  H_Q2_rand_sub      -> Add(H_Q2        ,H_Q2_rand       , 1, -1);
-  H_xbj_rand_sub     -> Add(H_xbj       ,H_xbj_rand      , 1, -1);
-  H_nu_rand_sub      -> Add(H_nu        ,H_nu_rand       , 1, -1);
-  H_q_rand_sub       -> Add(H_q         ,H_q_rand        , 1, -1);
-  H_Em_rand_sub      -> Add(H_Em        ,H_Em_rand       , 1, -1);
-  H_Em_nuc_rand_sub  -> Add(H_Em_nuc    ,H_Em_nuc_rand   , 1, -1);
-  H_Pm_rand_sub      -> Add(H_Pm        ,H_Pm_rand       , 1, -1);
-  H_MM_rand_sub      -> Add(H_MM        ,H_MM_rand       , 1, -1);
-  H_thxq_rand_sub    -> Add(H_thxq      ,H_thxq_rand     , 1, -1);
-  H_thrq_rand_sub    -> Add(H_thrq      ,H_thrq_rand     , 1, -1);  
+  //----Carry out the randoms subtraction: sub = real - P_scale_factor * rand (single pass over the bins of each histogram)-----
+  // NOTE: the random coincidence histograms themselves are left un-scaled (so RandSub() may be called on every online poll),
+  //       they are scaled down once, explicitly, at the end of ApplyWeight()
+  for(unsigned int i=0; i<rand_H1.size(); i++) { rand_subtract(rand_H1[i].real, rand_H1[i].rand, rand_H1[i].sub, P_scale_factor); }
+  for(unsigned int i=0; i<rand_H2.size(); i++) { rand_subtract(rand_H2[i].real, rand_H2[i].rand, rand_H2[i].sub, P_scale_factor); }
 
       
   // Get Counts of "good events for saving to CaFe Report File"
-  total_bins = H_W->GetNbinsX();  //Get total number of bins (excluding overflow) (same for total, reals randoms, provied same histo range)
-  
-  W_total = H_W          ->IntegralAndError(1, total_bins, W_total_err);
-  W_real  = H_W_rand_sub ->IntegralAndError(1, total_bins, W_real_err);
-  W_rand  = H_W_rand     ->IntegralAndError(1, total_bins, W_rand_err);
+  GetRandSubYield("H_W", W_total, W_total_err, W_real, W_real_err, W_rand, W_rand_err);
 
   W_total_rate = W_total / total_time_bcm_cut;  // # good elastic proton event rate
   W_real_rate = W_real / total_time_bcm_cut;
-   
-  total_bins = H_Pm->GetNbinsX(); 
-  Pm_total = H_Pm          ->IntegralAndError(1, total_bins, Pm_total_err);
-  Pm_real  = H_Pm_rand_sub ->IntegralAndError(1, total_bins, Pm_real_err);
-  Pm_rand  = H_Pm_rand     ->IntegralAndError(1, total_bins, Pm_rand_err);
+
+  GetRandSubYield("H_Pm", Pm_total, Pm_total_err, Pm_real, Pm_real_err, Pm_rand, Pm_rand_err);
 
   Pm_real_rate = Pm_real / total_time_bcm_cut;
 
+  GetRandSubYield("H_Em",     Em_total,     Em_total_err,     Em_real,     Em_real_err,     Em_rand,     Em_rand_err);
+  GetRandSubYield("H_Em_nuc", Em_nuc_total, Em_nuc_total_err, Em_nuc_real, Em_nuc_real_err, Em_nuc_rand, Em_nuc_rand_err);
+  GetRandSubYield("H_MM",     MM_total,     MM_total_err,     MM_real,     MM_real_err,     MM_rand,     MM_rand_err);
   
-  total_bins = H_Em->GetNbinsX(); 
-  Em_total = H_Em          ->IntegralAndError(1, total_bins, Em_total_err);
-  Em_real  = H_Em_rand_sub ->IntegralAndError(1, total_bins, Em_real_err);
-  Em_rand  = H_Em_rand     ->IntegralAndError(1, total_bins, Em_rand_err);
-  
-  total_bins = H_Em_nuc->GetNbinsX(); 
-  Em_nuc_total = H_Em_nuc          ->IntegralAndError(1, total_bins, Em_nuc_total_err);
-  Em_nuc_real  = H_Em_nuc_rand_sub ->IntegralAndError(1, total_bins, Em_nuc_real_err);
-  Em_nuc_rand  = H_Em_nuc_rand     ->IntegralAndError(1, total_bins, Em_nuc_rand_err);
-  
-  total_bins = H_MM->GetNbinsX(); 
-  MM_total = H_MM          ->IntegralAndError(1, total_bins, MM_total_err);
-  MM_real  = H_MM_rand_sub ->IntegralAndError(1, total_bins, MM_real_err);
-  MM_rand  = H_MM_rand     ->IntegralAndError(1, total_bins, MM_rand_err);
-  
+}
+
+//_______________________________________________________________________________
+void baseAnalyzer::GetRandSubYield(TString hist_name, Double_t &total, Double_t &total_err, Double_t &real, Double_t &real_err, Double_t &rand, Double_t &rand_err)
+{
+  /*
+    Brief: Get the integrated counts (and error), excluding under/overflow, of the total (main coin. peak), 
+    random-subtracted (real) and scaled randoms for a histogram registered with AddRandHist(), 
+    i.e., GetRandSubYield("H_Pm", ...). Must be called after RandSub(), and before the randoms are scaled in ApplyWeight()
+  */
   
+  for(unsigned int i=0; i<rand_H1.size(); i++) {
+
+    if(hist_name != rand_H1[i].real->GetName()) continue;
+    
+    total_bins = rand_H1[i].real->GetNbinsX(); 
+    total = rand_H1[i].real ->IntegralAndError(1, total_bins, total_err);
+    real  = rand_H1[i].sub  ->IntegralAndError(1, total_bins, real_err);
+    rand  = rand_H1[i].rand ->IntegralAndError(1, total_bins, rand_err);
+
+    // randoms histograms are un-scaled here (see RandSub())
+    rand     = P_scale_factor * rand;
+    rand_err = P_scale_factor * rand_err;
+    return;
+  }
   
+  cout << "WARNING: GetRandSubYield() -> " << hist_name.Data() << " is NOT registered for randoms subtraction (see AddRandHist()) " << endl;
+  total = total_err = real = real_err = rand = rand_err = 0.;
 }
 
 //_________________________________________________________
@@ -6407,6 +6757,8 @@ void baseAnalyzer::CalcEff()
   pTrkEff_singles = p_did_singles / p_should_singles; 
   pTrkEff_singles_err = sqrt(p_should_singles-p_did_singles) / p_should_singles;                                                            
 
+  //follow mode: the run constants are written to the skim ROOTfile only once the run has finished
+  if(follow_flag && !follow_last_poll) return;
   
   
   //========================================================
@@ -6811,6 +7163,10 @@ void baseAnalyzer::ApplyWeight()
 
   //Call the randoms subtraction method (after histos have been scaled by charge, etc), provided there was a coin. time cut flag  (after scaling all histograms above)
   RandSub();
+
+  //Scale Down the random coincidences histograms (once, after the final randoms subtraction) to the main coin. peak window
+  for(unsigned int i=0; i<rand_H1.size(); i++) { rand_H1[i].rand->Scale(P_scale_factor); }
+  for(unsigned int i=0; i<rand_H2.size(); i++) { rand_H2[i].rand->Scale(P_scale_factor); }
  
 }
 
@@ -8099,141 +8455,212 @@ void baseAnalyzer::WriteReportSummary()
 {
   
   // Method to write charge, efficiencies, live time and other relevant quantities to a data file
-  //  on a run-by-run basis, and self-updating file, meaning, each run that is replayed will be appended into the file.    
+  //  on a run-by-run basis, and self-updating file, meaning, each run that is replayed will be added into the file.    
 
   // Nov 27, 2022
   // Updating this method is work in progress, to make it into a .csv format for easy plotting via python
+
+  // The row of each run is written via summary_write_run() (see UTILS/summary_utils.h): the file is locked while
+  // being updated (farm jobs may write to the same file), a re-analyzed run replaces its previous row, and the
+  // header line below is the schema that every row must match.
   
   cout << "Calling WriteReportSummary() . . ." << endl;
 
   
   if(analysis_type=="data"){
 
-    //Check if file already exists
-    in_file.open(output_SummaryFileName.Data());
+    TString summary_header;   // column names (schema)
+    TString summary_row;      // values of this run
     
-    //---------------
-    // APPEND MODE
-    //---------------
-    //---------------------------------------------------------
-    if(!in_file.fail()){
-      
-      cout << "Summary File already exists, will append to it . . . " << endl;
-      
-      //Open Report FIle in append mode
-      
-      out_file.open(output_SummaryFileName, ios::out | ios::app);
+    if( (analysis_cut=="MF") || (analysis_cut=="SRC") || (analysis_cut=="heep_coin") ) {
       
+      // set appropiate heders for coincidence data
+      summary_header = "run,beam_time,charge,avg_current,total_Yield,total_Yield_err,real_Yield,real_Yield_err,random_Yield,random_Yield_err,hTrkEff,hTrkEff_err,pTrkEff,pTrkEff_err,cpuLT,cpuLT_err_Bi,tLT,tLT_err_Bi,S1X_rate,T1_scl_rate,T2_scl_rate,T3_scl_rate,T5_scl_rate,T1_accp_rate,T2_accp_rate,T3_accp_rate,T5_accp_rate,edtm_scl,edtm_accp,PS1,PS2,PS3,PS5,ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,hdc1u1_res,hdc1u2_res,hdc1x1_res,hdc1x2_res,hdc1v2_res,hdc1v1_res,hdc2v1_res,hdc2v2_res,hdc2x2_res,hdc2x1_res,hdc2u2_res,hdc2u1_res,hdc1u1_res_err,hdc1u2_res_err,hdc1x1_res_err,hdc1x2_res_err,hdc1v2_res_err,hdc1v1_res_err,hdc2v1_res_err,hdc2v2_res_err,hdc2x2_res_err,hdc2x1_res_err,hdc2u2_res_err,hdc2u1_res_err,pdc1u1_res,pdc1u2_res,pdc1x1_res,pdc1x2_res,pdc1v1_res,pdc1v2_res,pdc2v2_res,pdc2v1_res,pdc2x2_res,pdc2x1_res,pdc2u2_res,pdc2u1_res,pdc1u1_res_err,pdc1u2_res_err,pdc1x1_res_err,pdc1x2_res_err,pdc1v1_res_err,pdc1v2_res_err,pdc2v2_res_err,pdc2v1_res_err,pdc2x2_res_err,pdc2x1_res_err,pdc2u2_res_err,pdc2u1_res_err,multi_track_eff,multi_track_eff_err,T1_accp_singles,T2_accp_singles,pTrkEff_singles,pTrkEff_singles_err";
       
       if( (analysis_cut=="MF") || (analysis_cut=="SRC") ){  
-	
-	out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, Pm_total, Pm_total_err,Pm_real, Pm_real_err, Pm_rand, Pm_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma, hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err) << endl;
-	
+	summary_row = Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, Pm_total, Pm_total_err,Pm_real, Pm_real_err, Pm_rand, Pm_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma, hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err);
       }
       
       else if(analysis_cut=="heep_coin") {
-	out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err,W_real, W_real_err, W_rand, W_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err) << endl;
-	
+	summary_row = Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err,W_real, W_real_err, W_rand, W_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err);
       }
       
-      else if(analysis_cut=="heep_singles") {
-	out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err, pTrkEff, pTrkEff_err, cpuLT_trig_single, cpuLT_trig_err_Bi_single, tLT_trig_single, tLT_trig_err_Bi_single, S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err ) << endl;	
-      }
+    } // end coin data requirement
+    
+    if(analysis_cut=="heep_singles") {
       
-      out_file.close();
+      // set appropiate heders for singles data
+      summary_header = "run,beam_time,charge,avg_current,total_Yield,total_Yield_err,pTrkEff,pTrkEff_err,cpuLT,cpuLT_err_Bi,tLT,tLT_err_Bi,S1X_rate,T1_scl_rate,T2_scl_rate,T3_scl_rate,T5_scl_rate,T1_accp_rate,T2_accp_rate,T3_accp_rate,T5_accp_rate,edtm_scl,edtm_accp,PS1,PS2,PS3,PS5,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,pdc1u1_res,pdc1u2_res,pdc1x1_res,pdc1x2_res,pdc1v1_res,pdc1v2_res,pdc2v2_res,pdc2v1_res,pdc2x2_res,pdc2x1_res,pdc2u2_res,pdc2u1_res,pdc1u1_res_err,pdc1u2_res_err,pdc1x1_res_err,pdc1x2_res_err,pdc1v1_res_err,pdc1v2_res_err,pdc2v2_res_err,pdc2v1_res_err,pdc2x2_res_err,pdc2x1_res_err,pdc2u2_res_err,pdc2u1_res_err,multi_track_eff,multi_track_eff_err,T1_accp_singles,T2_accp_singles,pTrkEff_singles,pTrkEff_singles_err";
+      summary_row = Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err, pTrkEff, pTrkEff_err, cpuLT_trig_single, cpuLT_trig_err_Bi_single, tLT_trig_single, tLT_trig_err_Bi_single, S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err);
+    }
+
+    if(summary_header.IsNull()) return;
     
-    } // end check file exists      
     //---------------------------------------------------------
+    // parameters block (only written when the summary file is created by the 1st run)
+    //---------------------------------------------------------
+    tgt_areal_density =  tgt_density *  tgt_thickness;
+    
+    stringstream summary_comments;
+    summary_comments << "#-------------------------------------" << endl;
+    summary_comments << "#        Data Analysis Summary        " << endl;
+    summary_comments << "#-------------------------------------" << endl;
+    summary_comments << "#                                     " << endl;
+    summary_comments << "#                                     " << endl;
+    summary_comments << Form("# target_name: %s        kin_type:  %s            ", tgt_type.Data(), analysis_cut.Data() ) << endl;
+    summary_comments << Form("# target_amu: %.6f                 ", tgt_mass        ) << endl;
+    summary_comments << Form("# target_density [g/cm3]: %.4f     ", tgt_density     ) << endl;
+    summary_comments << Form("# target_thickness [cm]: %.4f      ", tgt_thickness     ) << endl;
+    summary_comments << Form("# target_areal_density [g/cm2]: %.4f",  tgt_areal_density    ) << endl;
+    summary_comments << "#" << endl;
+    summary_comments << "# N: " << N << endl;
+    summary_comments << "# Z: " << Z << endl;
+    summary_comments << "# A: " << A << endl;
+    summary_comments << "# transparency: " << T << endl;
+    summary_comments << "#" << endl;
+    summary_comments << Form("# beam_energy [GeV]: %.4f          ", beam_energy ) << endl;
+    summary_comments << "#" << endl;
+    summary_comments << Form("# hms_h_particle_mass [GeV]: %.6f          ",  hms_part_mass ) << endl;
+    summary_comments << Form("# hms_h_momentum [GeV/c]: %.4f             ",  hms_p ) << endl;
+    summary_comments << Form("# hms_h_angle [deg]: %.4f                  ",  hms_angle ) << endl;
+    summary_comments << "#" << endl;
+    summary_comments << Form("# shms_e_particle_mass [GeV]: %.6f          ",  shms_part_mass ) << endl;
+    summary_comments << Form("# shms_e_momentum [GeV/c]: %.4f             ",  shms_p ) << endl;
+    summary_comments << Form("# shms_e_angle [deg]: %.4f                  ",  shms_angle ) << endl;
+    summary_comments << "#" << endl;
+    summary_comments << Form("# %s_Current_Threshold [uA]: >%.2f ", bcm_type.Data(), bcm_thrs) << endl;
+    summary_comments << "# Units: time [sec] | charge [mC] | currnet [uA] | rates [kHz] |  efficiencies [fractional form]                       " << endl;
+    summary_comments << "#                       " << endl;
 
-    //---------------------
-    // CREATE SUMMARY FILE
-    //--------------------
     //---------------------------------------------------------
-    if(in_file.fail()){
+    // ADD (OR REPLACE) THIS RUN IN THE SUMMARY FILE
+    //---------------------------------------------------------
+    if(!summary_write_run(output_SummaryFileName.Data(), summary_comments.str(), summary_header.Data(), run, summary_row.Data())){
+      cout << Form("ERROR: WriteReportSummary() -> run %d could NOT be written to %s ! ! !", run, output_SummaryFileName.Data()) << endl;
+    }
+    
+  } // end "data" requirement
+  
+  cout << "Ending WriteReportSummary() . . ." << endl;
+  
+} //End WriteReport()
 
-      tgt_areal_density =  tgt_density *  tgt_thickness;
-      
-      cout << "Report File does NOT exist, will create one . . . " << endl;
-      
-      out_file.open(output_SummaryFileName);
-      out_file << "#-------------------------------------" << endl;
-      out_file << "#        Data Analysis Summary        " << endl;
-      out_file << "#-------------------------------------" << endl;
-      out_file << "#                                     " << endl;
-      out_file << "#                                     " << endl;      
-      out_file << Form("# target_name: %s        kin_type:  %s            ", tgt_type.Data(), analysis_cut.Data() ) << endl;
-      out_file << Form("# target_amu: %.6f                 ", tgt_mass        ) << endl;
-      out_file << Form("# target_density [g/cm3]: %.4f     ", tgt_density     ) << endl;
-      out_file << Form("# target_thickness [cm]: %.4f      ", tgt_thickness     ) << endl;
-      out_file << Form("# target_areal_density [g/cm2]: %.4f",  tgt_areal_density    ) << endl;
-      out_file << "#" << endl;
-      out_file << "# N: " << N << endl;
-      out_file << "# Z: " << Z << endl;
-      out_file << "# A: " << A << endl;
-      out_file << "# transparency: " << T << endl;      
-      out_file << "#" << endl;
-      out_file << Form("# beam_energy [GeV]: %.4f          ", beam_energy ) << endl;            
-      out_file << "#" << endl;      
-      out_file << Form("# hms_h_particle_mass [GeV]: %.6f          ",  hms_part_mass ) << endl;          
-      out_file << Form("# hms_h_momentum [GeV/c]: %.4f             ",  hms_p ) << endl;
-      out_file << Form("# hms_h_angle [deg]: %.4f                  ",  hms_angle ) << endl;          
-      out_file << "#" << endl;      
-      out_file << Form("# shms_e_particle_mass [GeV]: %.6f          ",  shms_part_mass ) << endl;          
-      out_file << Form("# shms_e_momentum [GeV/c]: %.4f             ",  shms_p ) << endl;
-      out_file << Form("# shms_e_angle [deg]: %.4f                  ",  shms_angle ) << endl;  
-      out_file << "#" << endl;      
-      out_file << Form("# %s_Current_Threshold [uA]: >%.2f ", bcm_type.Data(), bcm_thrs) << endl;
-      out_file << "# Units: time [sec] | charge [mC] | currnet [uA] | rates [kHz] |  efficiencies [fractional form]                       " << endl;
-      out_file << "#                       " << endl;
+
+//_______________________________________________________________________________
+void baseAnalyzer::WriteTimeSlices()
+{
+  /*
+    Brief: Method to write the yield, EDTM, trigger counts and tracking efficiency numerator/denominator
+    accumulated per time slice (scaler interval or time_slice_width) to a .csv table, on a run-by-run basis.
+    Only scaler intervals that passed the BCM current cut are accumulated, so slices with beam_time=0 had no beam.
+    The run totals (report file) are the sums over all slices (up to the pre-scale, EDTM subtraction applied here).
+
+    These tables allow current-dependence (e.g. target boiling) studies without re-analyzing runs with different
+    bcm thresholds: select slices by avg_current and sum the relevant columns.
+  */
+  
+  if(!time_slice_flag || analysis_type!="data") return;
+
+  cout << "Calling WriteTimeSlices() . . ." << endl;
+
+  out_file.open(output_TimeSliceFileName);
+
+  out_file << "# CaFe time-sliced yield / normalization table" << endl;
+  out_file << Form("# run: %d  | target: %s  | analysis_cut: %s ", run, tgt_type.Data(), analysis_cut.Data()) << endl;
+  out_file << Form("# bcm: %s  | bcm_thrs [uA]: %.3f  | time_slice_width [sec]: %.1f (<=0 -> per scaler interval) ", bcm_type.Data(), bcm_thrs, time_slice_width) << endl;
+  out_file << Form("# pre-scale factors: PS1=%.1f, PS2=%.1f, PS3=%.1f, PS4=%.1f, PS5=%.1f, PS6=%.1f ", Ps1_factor, Ps2_factor, Ps3_factor, Ps4_factor, Ps5_factor, Ps6_factor) << endl;
+  out_file << Form("# randoms scale factor (main coin. peak / accidentals window): %.5f ", P_scale_factor) << endl;
+  out_file << "# " << endl;
+  out_file << "# header definitions: " << endl;
+  out_file << "# t_start, t_end       : run time at the slice start/end [sec]" << endl;
+  out_file << "# beam_time, charge    : beam time [sec] and charge [mC] that passed the bcm cut" << endl;
+  out_file << "# avg_current          : charge / beam_time [uA]" << endl;
+  out_file << "# T#_scl, edtm_scl     : trigger (EDTM-subtracted) and EDTM scaler counts" << endl;
+  out_file << "# T#_accp, edtm_accp   : accepted trigger (no EDTM, NOT pre-scale corrected) and EDTM counts" << endl;
+  out_file << "# T2_accp_singles      : accepted SHMS T2 singles" << endl;
+  out_file << "# h_did, h_should, p_did, p_should : HMS/SHMS tracking efficiency numerator/denominator" << endl;
+  out_file << "# total_Yield, random_Yield : counts passing all cuts within the main coin. peak / accidentals window (random_Yield NOT scaled)" << endl;
+  out_file << "slice,t_start,t_end,beam_time,charge,avg_current,T1_scl,T2_scl,T3_scl,T4_scl,T5_scl,T6_scl,edtm_scl,T1_accp,T2_accp,T3_accp,T4_accp,T5_accp,T6_accp,edtm_accp,T2_accp_singles,h_did,h_should,p_did,p_should,total_Yield,random_Yield" << endl;
+
+  Double_t ts_current;
+  
+  for(int is=0; is<nslices; is++){
+
+    ts_current = ts_time_bcm_cut[is] > 0. ? ts_charge_bcm_cut[is] / ts_time_bcm_cut[is] : 0.;
+
+    out_file << Form("%d,%.3f,%.3f,%.3f,%.6f,%.3f,", is, ts_time_start[is], ts_time_end[is], ts_time_bcm_cut[is], ts_charge_bcm_cut[is]/1000., ts_current);
+
+    for(int itrg=0; itrg<6; itrg++){ out_file << Form("%.0f,", ts_trig_scaler_bcm_cut[itrg][is] - ts_edtm_scaler_bcm_cut[is]); }
+    out_file << Form("%.0f,", ts_edtm_scaler_bcm_cut[is]);
     
+    for(int itrg=0; itrg<6; itrg++){ out_file << Form("%.0f,", ts_trig_accp_bcm_cut[itrg][is]); }
+    out_file << Form("%.0f,%.0f,", ts_edtm_accp_bcm_cut[is], ts_trig2_singles_accp[is]);
     
-      if( (analysis_cut=="MF") || (analysis_cut=="SRC") || (analysis_cut=="heep_coin") ) {
-	
-	// set appropiate heders for coincidence data
-	out_file << "run,beam_time,charge,avg_current,total_Yield,total_Yield_err,real_Yield,real_Yield_err,random_Yield,random_Yield_err,hTrkEff,hTrkEff_err,pTrkEff,pTrkEff_err,cpuLT,cpuLT_err_Bi,tLT,tLT_err_Bi,S1X_rate,T1_scl_rate,T2_scl_rate,T3_scl_rate,T5_scl_rate,T1_accp_rate,T2_accp_rate,T3_accp_rate,T5_accp_rate,edtm_scl,edtm_accp,PS1,PS2,PS3,PS5,ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,hdc1u1_res,hdc1u2_res,hdc1x1_res,hdc1x2_res,hdc1v2_res,hdc1v1_res,hdc2v1_res,hdc2v2_res,hdc2x2_res,hdc2x1_res,hdc2u2_res,hdc2u1_res,hdc1u1_res_err,hdc1u2_res_err,hdc1x1_res_err,hdc1x2_res_err,hdc1v2_res_err,hdc1v1_res_err,hdc2v1_res_err,hdc2v2_res_err,hdc2x2_res_err,hdc2x1_res_err,hdc2u2_res_err,hdc2u1_res_err,pdc1u1_res,pdc1u2_res,pdc1x1_res,pdc1x2_res,pdc1v1_res,pdc1v2_res,pdc2v2_res,pdc2v1_res,pdc2x2_res,pdc2x1_res,pdc2u2_res,pdc2u1_res,pdc1u1_res_err,pdc1u2_res_err,pdc1x1_res_err,pdc1x2_res_err,pdc1v1_res_err,pdc1v2_res_err,pdc2v2_res_err,pdc2v1_res_err,pdc2x2_res_err,pdc2x1_res_err,pdc2u2_res_err,pdc2u1_res_err,multi_track_eff,multi_track_eff_err,T1_accp_singles,T2_accp_singles,pTrkEff_singles,pTrkEff_singles_err" << endl;
-	
-	
-	if( (analysis_cut=="MF") || (analysis_cut=="SRC") ){  
-	  
-	  out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, Pm_total, Pm_total_err,Pm_real, Pm_real_err, Pm_rand, Pm_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma, hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err) << endl;
-	  
-	}
-	
-	else if(analysis_cut=="heep_coin") {
-	  
-	  out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err,W_real, W_real_err, W_rand, W_rand_err, hTrkEff, hTrkEff_err, pTrkEff, pTrkEff_err, cpuLT_trig_coin, cpuLT_trig_err_Bi_coin, tLT_trig_coin, tLT_trig_err_Bi_coin,S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor, ctime_offset,ctime_sigma,hbeta_mean,hbeta_sigma,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,hdc_res_sigma[0],hdc_res_sigma[1],hdc_res_sigma[2],hdc_res_sigma[3],hdc_res_sigma[4],hdc_res_sigma[5],hdc_res_sigma[6],hdc_res_sigma[7],hdc_res_sigma[8],hdc_res_sigma[9],hdc_res_sigma[10],hdc_res_sigma[11],hdc_res_sigma_err[0],hdc_res_sigma_err[1],hdc_res_sigma_err[2],hdc_res_sigma_err[3],hdc_res_sigma_err[4],hdc_res_sigma_err[5],hdc_res_sigma_err[6],hdc_res_sigma_err[7],hdc_res_sigma_err[8],hdc_res_sigma_err[9],hdc_res_sigma_err[10],hdc_res_sigma_err[11],pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err) << endl;	  
-	  
-	}
-     
-	
-      } // end coin data requirement
-      
-      if(analysis_cut=="heep_singles") {
+    out_file << Form("%.0f,%.0f,%.0f,%.0f,%.0f,%.0f", ts_h_did[is], ts_h_should[is], ts_p_did[is], ts_p_should[is], ts_yield_total[is], ts_yield_rand[is]) << endl;
+    
+  }
+  
+  out_file.close();
 
-	// set appropiate heders for coincidence data
-	out_file << "run,beam_time,charge,avg_current,total_Yield,total_Yield_err,pTrkEff,pTrkEff_err,cpuLT,cpuLT_err_Bi,tLT,tLT_err_Bi,S1X_rate,T1_scl_rate,T2_scl_rate,T3_scl_rate,T5_scl_rate,T1_accp_rate,T2_accp_rate,T3_accp_rate,T5_accp_rate,edtm_scl,edtm_accp,PS1,PS2,PS3,PS5,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,pdc1u1_res,pdc1u2_res,pdc1x1_res,pdc1x2_res,pdc1v1_res,pdc1v2_res,pdc2v2_res,pdc2v1_res,pdc2x2_res,pdc2x1_res,pdc2u2_res,pdc2u1_res,pdc1u1_res_err,pdc1u2_res_err,pdc1x1_res_err,pdc1x2_res_err,pdc1v1_res_err,pdc1v2_res_err,pdc2v2_res_err,pdc2v1_res_err,pdc2x2_res_err,pdc2x1_res_err,pdc2u2_res_err,pdc2u1_res_err,multi_track_eff,multi_track_eff_err,T1_accp_singles,T2_accp_singles,pTrkEff_singles,pTrkEff_singles_err" << endl;
-	out_file << Form("%i,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3f,%.3E,%.3f,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3E,%.3f,%.3f,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3E,%.3E,%.3f,%.3f", run, total_time_bcm_cut, total_charge_bcm_cut, avg_current_bcm_cut, W_total, W_total_err, pTrkEff, pTrkEff_err, cpuLT_trig_single, cpuLT_trig_err_Bi_single, tLT_trig_single, tLT_trig_err_Bi_single, S1XscalerRate_bcm_cut, TRIG1scalerRate_bcm_cut, TRIG2scalerRate_bcm_cut, TRIG3scalerRate_bcm_cut, TRIG5scalerRate_bcm_cut, TRIG1accpRate_bcm_cut, TRIG2accpRate_bcm_cut, TRIG3accpRate_bcm_cut, TRIG5accpRate_bcm_cut, total_edtm_scaler_bcm_cut, total_edtm_accp_bcm_cut, Ps1_factor, Ps2_factor, Ps3_factor, Ps5_factor,pbeta_mean,pbeta_sigma,pcal_mean,pcal_sigma,pdc_res_sigma[0],pdc_res_sigma[1],pdc_res_sigma[2],pdc_res_sigma[3],pdc_res_sigma[4],pdc_res_sigma[5],pdc_res_sigma[6],pdc_res_sigma[7],pdc_res_sigma[8],pdc_res_sigma[9],pdc_res_sigma[10],pdc_res_sigma[11],pdc_res_sigma_err[0],pdc_res_sigma_err[1],pdc_res_sigma_err[2],pdc_res_sigma_err[3],pdc_res_sigma_err[4],pdc_res_sigma_err[5],pdc_res_sigma_err[6],pdc_res_sigma_err[7],pdc_res_sigma_err[8],pdc_res_sigma_err[9],pdc_res_sigma_err[10],pdc_res_sigma_err[11],multi_track_eff,multi_track_eff_err,total_trig1_singles_accp,total_trig2_singles_accp,pTrkEff_singles,pTrkEff_singles_err) << endl;	
+  cout << Form("Wrote %d time slices to: %s", nslices, output_TimeSliceFileName.Data()) << endl;
+  
+}
 
-      }
-      
-      
-      out_file.close();
-      in_file.close();
+//_______________________________________________________________________________
+void baseAnalyzer::WriteBCMScan()
+{
+  /*
+    Brief: Method to write the charge, beam time, EDTM, trigger counts, tracking efficiency numerator/denominator
+    and yields accumulated for each BCM scan point (BCM, current threshold) to a .csv table, on a run-by-run basis.
+    All scan points are evaluated in the same pass, so the charge / yield dependence on the bcm cut does not
+    require re-analyzing the run once per threshold.
+  */
+  
+  if(!bcm_scan_flag || analysis_type!="data") return;
+
+  cout << "Calling WriteBCMScan() . . ." << endl;
+
+  out_file.open(output_BCMScanFileName);
 
+  out_file << "# CaFe bcm current threshold scan table" << endl;
+  out_file << Form("# run: %d  | target: %s  | analysis_cut: %s ", run, tgt_type.Data(), analysis_cut.Data()) << endl;
+  out_file << Form("# nominal bcm: %s  | nominal bcm_thrs [uA]: %.3f ", bcm_type.Data(), bcm_thrs) << endl;
+  out_file << Form("# pre-scale factors: PS1=%.1f, PS2=%.1f, PS3=%.1f, PS4=%.1f, PS5=%.1f, PS6=%.1f ", Ps1_factor, Ps2_factor, Ps3_factor, Ps4_factor, Ps5_factor, Ps6_factor) << endl;
+  out_file << Form("# randoms scale factor (main coin. peak / accidentals window): %.5f ", P_scale_factor) << endl;
+  out_file << "# " << endl;
+  out_file << "# header definitions: " << endl;
+  out_file << "# bcm, bcm_thrs        : BCM and current threshold [uA] of the scan point (scaler reads with current > bcm_thrs are kept)" << endl;
+  out_file << "# beam_time, charge    : beam time [sec] and charge [mC] that passed the bcm cut" << endl;
+  out_file << "# avg_current          : charge / beam_time [uA]" << endl;
+  out_file << "# T#_scl, edtm_scl     : trigger (EDTM-subtracted) and EDTM scaler counts" << endl;
+  out_file << "# T#_accp, edtm_accp   : accepted trigger (no EDTM, NOT pre-scale corrected) and EDTM counts" << endl;
+  out_file << "# h_did, h_should, p_did, p_should : HMS/SHMS tracking efficiency numerator/denominator" << endl;
+  out_file << "# total_Yield, random_Yield : counts passing all cuts within the main coin. peak / accidentals window (random_Yield NOT scaled)" << endl;
+  out_file << "bcm,bcm_thrs,beam_time,charge,avg_current,T1_scl,T2_scl,T3_scl,T4_scl,T5_scl,T6_scl,edtm_scl,T1_accp,T2_accp,T3_accp,T4_accp,T5_accp,T6_accp,edtm_accp,h_did,h_should,p_did,p_should,total_Yield,random_Yield" << endl;
 
-    } // end file check for 1st run
+  Double_t bs_current;
   
-      //-------------------------------------------
-    
+  for(int j=0; j<nscan; j++){
+
+    bs_current = bs_time_bcm_cut[j] > 0. ? bs_charge_bcm_cut[j] / bs_time_bcm_cut[j] : 0.;
+
+    out_file << Form("%s,%.3f,%.3f,%.6f,%.3f,", bs_bcm_type[j].Data(), bs_bcm_thrs[j], bs_time_bcm_cut[j], bs_charge_bcm_cut[j]/1000., bs_current);
 
+    for(int itrg=0; itrg<6; itrg++){ out_file << Form("%.0f,", bs_trig_scaler_bcm_cut[itrg][j] - bs_edtm_scaler_bcm_cut[j]); }
+    out_file << Form("%.0f,", bs_edtm_scaler_bcm_cut[j]);
     
+    for(int itrg=0; itrg<6; itrg++){ out_file << Form("%.0f,", bs_trig_accp_bcm_cut[itrg][j]); }
+    out_file << Form("%.0f,", bs_edtm_accp_bcm_cut[j]);
     
-  } // end "data" requirement
-  
-  cout << "Ending WriteReportSummary() . . ." << endl;
+    out_file << Form("%.0f,%.0f,%.0f,%.0f,%.0f,%.0f", bs_h_did[j], bs_h_should[j], bs_p_did[j], bs_p_should[j], bs_yield_total[j], bs_yield_rand[j]) << endl;
+    
+  }
   
-} //End WriteReport()
+  out_file.close();
 
+  cout << Form("Wrote %d bcm scan points to: %s", nscan, output_BCMScanFileName.Data()) << endl;
+  
+}
 
 //_______________________________________________________________________________
 void baseAnalyzer::CombineHistos()
@@ -9019,21 +9446,256 @@ Double_t baseAnalyzer::GetLuminosity(TString user_input="")
 //______________________________________________________________________________
 void baseAnalyzer::MakePlots()
 {
+  /*
+    Brief: Make the online plot book (multi-page .pdf) directly from the histograms already
+    filled in memory (must be called after WriteHist()), instead of re-reading the output ROOTfile
+    in a separate ROOT session (UTILS_CAFE/online_scripts/make_online_plots.cpp, still available for offline use).
+
+    The pages are described once (plot_book, see AddPlotPage()), and rendered by online_plots_nworkers
+    forked workers (each worker has its own copy of the histograms and graphics state), one .pdf per page.
+    The pages are then merged (pdfunite or gs) into the final .pdf. If no merge tool is found (or nworkers<=1),
+    the pages are rendered serially into a single multi-page .pdf.
+
+    NOTE: only called at the end of the online (follow) mode, run_data_follow(). The (offline) run_data_analysis()
+    does not make the plot book, use online_scripts/make_online_plots.cpp on its output ROOTfile instead.
+  */
+  
   cout << "Calling MakePlots() . . . " << endl;
 
-  string cmd0 = Form("emacs %s", output_ReportFileName.Data());
-  cout << cmd0.c_str() << endl;
-  gSystem->Exec(cmd0.c_str());
+  if(analysis_cut=="optics") return;
 
+  TStopwatch sw;
+  sw.Start();
   
-  Bool_t simc_exist = !gSystem->AccessPathName(  simc_OutputFileName_rad );
- 
+  TString outPDF = Form("CAFE_OUTPUT/PDF/cafe_output_%s_%d_%d.pdf", replay_type.Data(), run, evtNum);
+
+  // SIMC histograms (if available) are overlaid on the single-histogram (data) pads
+  // (the SIMC file is opened by each worker, since forked processes must not share the same file offset)
+  Bool_t simc_exist = !gSystem->AccessPathName( simc_OutputFileName_rad );
+  
+  //---------------- PAGE DEFINITIONS -----------------
+  plot_book.clear();
+  
+  TString Em_name = (tgt_type=="LH2") ? "H_Em" : "H_Em_nuc";
+
+  // selected data: total = signal + background ( {total, random-subtracted, randoms} )
+  if(analysis_cut!="heep_singles") {
+    AddPlotPage(1, 1, 1, { {"H_ep_ctime_total", "H_ep_ctime_real", "H_ep_ctime_rand"} });
+    AddPlotPage(1, 1, 1, { {"H_W", "H_W_rand_sub", "H_W_rand"} });
+    AddPlotPage(1, 1, 1, { {"H_MM", "H_MM_rand_sub", "H_MM_rand"} });
+    AddPlotPage(1, 1, 1, { {"H_Pm", "H_Pm_rand_sub", "H_Pm_rand"} });
+    AddPlotPage(1, 1, 1, { {Em_name, Em_name+"_rand_sub", Em_name+"_rand"} });
+  }
+  else {
+    AddPlotPage(1, 1, 1, { {"H_W"} });
+  }
+
+  // 2D nuclear missing energy vs. Pm
+  if(tgt_type!="LH2") {
+    AddPlotPage(1, 2, 0, { {"H_Em_nuc_vs_Pm_ACCP_PID_CTIME_CUTS"}, {"H_Em_src_vs_Pm_ACCP_PID_CTIME_CUTS"} });
+  }
+
+  // kinematics (data / SIMC)
+  AddPlotPage(3, 3, 0, { {"H_Q2"}, {"H_nu"}, {"H_W"}, {"H_thq"}, {"H_xbj"}, {"H_the"}, {"H_kf"}, {Em_name}, {"H_MM"} });
+  AddPlotPage(3, 3, 0, { {"H_Pm"}, {"H_Pf"}, {"H_thx"}, {"H_q"}, {"H_thxq"}, {"H_thrq"}, {"H_Pmx_Lab"}, {"H_Pmy_Lab"}, {"H_Pmz_Lab"} });
+
+  // focal plane, reconstructed and target vertex (data / SIMC)
+  AddPlotPage(2, 2, 0, { {"H_exfp"}, {"H_eyfp"}, {"H_expfp"}, {"H_eypfp"} });
+  AddPlotPage(2, 2, 0, { {"H_hxfp"}, {"H_hyfp"}, {"H_hxpfp"}, {"H_hypfp"} });
+  AddPlotPage(2, 2, 0, { {"H_eytar"}, {"H_exptar"}, {"H_eyptar"}, {"H_edelta"} });
+  AddPlotPage(2, 2, 0, { {"H_hytar"}, {"H_hxptar"}, {"H_hyptar"}, {"H_hdelta"} });
+  AddPlotPage(3, 2, 0, { {"H_htar_x"}, {"H_htar_y"}, {"H_htar_z"}, {"H_etar_x"}, {"H_etar_y"}, {"H_etar_z"} });
+
+  Int_t npages = plot_book.size();
+
+  //---------------- RENDERING -----------------
+  gROOT->SetBatch(kTRUE);
+  gStyle->SetOptStat(0);
+
+  // tool to merge the single-page .pdf files
+  TString merge_cmd = "";
+  char *pdfunite = gSystem->Which(gSystem->Getenv("PATH"), "pdfunite", kExecutePermission);
+  char *gs       = gSystem->Which(gSystem->Getenv("PATH"), "gs", kExecutePermission);
+  if(pdfunite)  merge_cmd = "pdfunite";
+  else if(gs)   merge_cmd = Form("gs -q -dBATCH -dNOPAUSE -sDEVICE=pdfwrite -sOutputFile=%s", outPDF.Data());
+  delete [] pdfunite;
+  delete [] gs;
+  
+  Bool_t parallel = online_plots_nworkers>1 && merge_cmd!="";
+  
+  if(parallel) {
+
+    TString page_dir = Form("CAFE_OUTPUT/PDF/pages_%s_%d_%d", replay_type.Data(), run, evtNum);
+    gSystem->mkdir(page_dir.Data(), kTRUE);
     
-  string cmd=Form("root -l -q -b \"UTILS_CAFE/online_scripts/make_online_plots.cpp(%d, %d, %i, \\\"%s\\\", \\\"%s\\\", \\\"%s\\\", \\\"%s\\\", \\\"%s\\\", 1)\" ", run, evtNum, simc_exist, tgt_type.Data(), replay_type.Data(), analysis_cut.Data(), data_OutputFileName.Data(), simc_OutputFileName_rad.Data());
-  cout << cmd.c_str() << endl;
+    // each (forked) worker renders its page(s) into a separate .pdf
+    ROOT::TProcessExecutor workers( min(online_plots_nworkers, npages) );
+    workers.Map( [&](Int_t ipage) {
+	if(simc_exist) simc_plots_file = TFile::Open( simc_OutputFileName_rad.Data(), "READ" );
+	
+	TCanvas *c = new TCanvas(Form("c_page%d", ipage), "cafe_output", 2000, 1000);
+	DrawPlotPage(ipage, c);
+	c->Print(Form("%s/page_%03d.pdf", page_dir.Data(), ipage));
+	delete c;
+
+	if(simc_plots_file) { simc_plots_file->Close(); delete simc_plots_file; simc_plots_file = NULL; }
+	return 0;
+      }, ROOT::TSeqI(npages) );
+
+    // merge pages (in order)
+    TString page_list = "";
+    for(Int_t ipage=0; ipage<npages; ipage++) { page_list += Form(" %s/page_%03d.pdf", page_dir.Data(), ipage); }
+
+    if(merge_cmd=="pdfunite") { gSystem->Exec(Form("pdfunite %s %s", page_list.Data(), outPDF.Data())); }
+    else                      { gSystem->Exec(Form("%s %s", merge_cmd.Data(), page_list.Data())); }
+    
+    gSystem->Exec(Form("rm -rf %s", page_dir.Data()));
+  }
 
-  if(analysis_cut!="optics"){
-    gSystem->Exec(cmd.c_str());
+  else {
+
+    // serial: single multi-page .pdf
+    if(simc_exist) simc_plots_file = TFile::Open( simc_OutputFileName_rad.Data(), "READ" );
+    
+    TCanvas *c = new TCanvas("c_page", "cafe_output", 2000, 1000);
+    c->Print(outPDF + "[");
+    for(Int_t ipage=0; ipage<npages; ipage++) {
+      DrawPlotPage(ipage, c);
+      c->Print(outPDF);
+    }
+    c->Print(outPDF + "]");
+    delete c;
+    
+    if(simc_plots_file) { simc_plots_file->Close(); delete simc_plots_file; simc_plots_file = NULL; }
+  }
+  
+  sw.Stop();
+  cout << Form("MakePlots(): %d pages written to %s (%s, %.1f sec)", npages, outPDF.Data(),
+	       parallel ? Form("%d workers", online_plots_nworkers) : "serial", sw.RealTime()) << endl;
+  
+}
+
+//______________________________________________________________________________
+void baseAnalyzer::AddPlotPage(Int_t nx, Int_t ny, Bool_t logy, vector< vector<TString> > pads)
+{
+  // Brief: add a page to the online plot book (see MakePlots()), pads are filled left-to-right, top-to-bottom
+  
+  plot_page page;
+  page.nx   = nx;
+  page.ny   = ny;
+  page.logy = logy;
+  page.pads = pads;
+  
+  plot_book.push_back(page);
+}
+
+//______________________________________________________________________________
+TH1 *baseAnalyzer::GetPlotHist(TString hname)
+{
+  // Brief: find a (data) histogram by name in the histogram lists
+  
+  TList *lists[6] = {kin_HList, pid_HList, accp_HList, randSub_HList, rand_HList, quality_HList};
+  
+  for(int i=0; i<6; i++) {
+    if(lists[i]==NULL) continue;
+    TH1 *h = (TH1*)lists[i]->FindObject(hname);
+    if(h) return h;
+  }
+  return NULL;
+}
+
+//______________________________________________________________________________
+void baseAnalyzer::DrawPlotPage(Int_t ipage, TCanvas *c)
+{
+  /*
+    Brief: draw one page of the online plot book on canvas c
+    pads with {total, real, rand} histograms are overlaid (with integrated counts in the legend),
+    pads with a single data histogram are compared to SIMC (if available), area-normalized
+  */
+
+  plot_page &page = plot_book[ipage];
+  Int_t npads = page.nx*page.ny;
+  
+  c->Clear();
+  if(npads > 1) c->Divide(page.nx, page.ny);
+
+  for(unsigned int ipad=0; ipad<page.pads.size(); ipad++) {
+
+    if((Int_t)ipad >= npads) {
+      cout << Form("WARNING: MakePlots() -> page %d has %d pads, histogram %s NOT drawn", ipage, npads, page.pads[ipad][0].Data()) << endl;
+      continue;
+    }
+    
+    // an undivided canvas has no sub-pads, draw on the canvas itself
+    if(npads > 1) c->cd(ipad+1);
+    else          c->cd();
+    if(page.logy) gPad->SetLogy();
+
+    vector<TString> &hnames = page.pads[ipad];
+    TH1 *h_data = GetPlotHist(hnames[0]);
+    
+    if(h_data==NULL) {
+      cout << Form("WARNING: MakePlots() -> histogram %s NOT found", hnames[0].Data()) << endl;
+      continue;
+    }
+
+    // 2D histograms
+    if(h_data->GetDimension()==2) { h_data->Draw("colz"); continue; }
+
+    TLegend *leg = new TLegend(0.63,0.6,0.8,0.8);
+    leg->SetBorderSize(0);
+    
+    // total (signal + background), random-subtracted and randoms
+    if(hnames.size()==3) {
+
+      TString label[3] = {"Total   ", "Reals   ", "Randoms "};
+      Color_t clr[3]   = {kBlue, kMagenta, kGreen};
+      Int_t   fill[3]  = {3004, 3006, 3005};
+      
+      h_data->GetYaxis()->SetRangeUser(0.5, h_data->GetMaximum()+1.e5);
+      
+      for(int k=0; k<3; k++) {
+	TH1 *h = GetPlotHist(hnames[k]);
+	if(h==NULL) continue;
+	
+	h->SetFillColorAlpha(clr[k], 0.35);
+	h->SetFillStyle(fill[k]);
+	h->SetLineColor(k==0 ? kBlue+2 : clr[k]);
+	h->Draw(k==0 ? "histE0" : "sameshistE0");
+	
+	Double_t I_err;
+	Double_t I = h->IntegralAndError(1, h->GetNbinsX(), I_err);
+	leg->AddEntry(h, Form("%s: %.3f", label[k].Data(), I), "f");
+      }
+      leg->SetTextSize(0.05);
+    }
+
+    // data (vs. SIMC)
+    else {
+
+      TH1 *h_simc = NULL;
+      if(simc_plots_file) {
+	TString dirs[2] = {"kin_plots", "accp_plots"};
+	for(int k=0; k<2 && h_simc==NULL; k++) { simc_plots_file->GetObject(dirs[k] + "/" + hnames[0], h_simc); }
+      }
+      
+      h_data->SetFillColorAlpha(kBlue, 0.35);
+      h_data->SetFillStyle(3004);
+      h_data->SetLineColor(kBlue+2);
+      
+      if(h_simc) {
+	h_simc->SetLineColor(kRed);
+	h_simc->SetLineWidth(2);
+	h_simc->DrawNormalized("hist");
+	h_data->DrawNormalized("sameshistE0");
+	leg->AddEntry(h_simc, "SIMC");
+      }
+      else { h_data->DrawNormalized("histE0"); }
+      
+      leg->AddEntry(h_data, "Data", "f");
+    }
+
+    leg->Draw();
   }
   
 }
@@ -9077,10 +9739,12 @@ void baseAnalyzer::run_data_analysis()
   WriteHist();
   WriteOfflineReport();
   WriteReportSummary();   
+  WriteTimeSlices();
+  WriteBCMScan();
   CombineHistos();
   
 
-  // --- online methods ---
+  // --- online methods (made in follow mode, see run_data_follow()) ---
   //WriteOnlineReport();    
   //MakePlots();
   
@@ -9089,6 +9753,110 @@ void baseAnalyzer::run_data_analysis()
   
 }
 
+//______________________________________________________________________________
+void baseAnalyzer::run_data_follow()
+{
+
+  /*
+    Brief: Online (follow) mode of run_data_analysis(). While the replay is still writing the ROOTfile,
+    the file is re-opened every follow_poll_sec and only the scaler reads / data entries appended since the
+    previous poll are analyzed (scaler interval, counters and histograms are carried over between polls).
+    After each poll, the (un-weighted, random-subtracted) histograms and the online report are updated.
+    
+    Once the ROOTfile has not grown for follow_timeout_sec, the run is considered finished, and the
+    same final steps as in run_data_analysis() are done (weights, offline report, skim trees, etc.)
+
+    NOTE: CalcEff() converts the charges in place (uC -> mC), so these are restored after every
+    intermediate poll, and ApplyWeight() (which scales the histograms in place) is only called once at the end.
+    RandSub() does not modify the real/random coin. histograms (the randoms are only scaled in ApplyWeight()),
+    so calling it on every poll does not affect the final random-subtracted histograms or yields.
+  */
+  
+  //------------------
+  Init();
+  ReadInputFile(true, false);  // boolean : (set_input_fnames, set_output_fnames)
+  ReadReport();
+  ReadInputFile(false, true);
+  SetHistBins();
+  CreateHist();
+
+  follow_flag = 1;
+  
+  Long64_t nentries_prev = -1;
+  Long64_t scal_entries_prev = -1;
+  Int_t idle_sec = 0;
+  Double_t charge_raw[6];
+  
+  while(true){
+
+    // re-open the ROOTfile and check if it is still growing
+    ReadScalerTree();
+    ReadTree();
+
+    if(nentries==nentries_prev && scal_entries==scal_entries_prev) { idle_sec += follow_poll_sec; }
+    else { idle_sec = 0; }
+
+    nentries_prev     = nentries;
+    scal_entries_prev = scal_entries;
+    follow_last_poll  = idle_sec >= follow_timeout_sec;
+
+    cout << Form("run_data_follow(): poll %d | scaler reads: %lld | entries: %lld | idle: %d sec", follow_npoll, scal_entries, nentries, idle_sec) << endl;
+    
+    // wait for enough entries to find the coin. time peak (see GetPeak())
+    if(follow_npoll==0 && nentries<follow_min_entries && !follow_last_poll){
+      gSystem->Sleep(follow_poll_sec*1000);
+      continue;
+    }
+    
+    ScalerEventLoop();
+    EventLoop();
+
+    if(follow_last_poll) break;
+
+    //----intermediate update----
+    charge_raw[0] = total_charge_bcm_cut;
+    charge_raw[1] = total_charge_bcm1_cut;
+    charge_raw[2] = total_charge_bcm2_cut;
+    charge_raw[3] = total_charge_bcm4a_cut;
+    charge_raw[4] = total_charge_bcm4b_cut;
+    charge_raw[5] = total_charge_bcm4c_cut;
+    
+    CalcEff();
+    RandSub();
+    WriteHist();
+    WriteOnlineReport();
+
+    delete outROOT; outROOT = NULL;
+    
+    total_charge_bcm_cut   = charge_raw[0];
+    total_charge_bcm1_cut  = charge_raw[1];
+    total_charge_bcm2_cut  = charge_raw[2];
+    total_charge_bcm4a_cut = charge_raw[3];
+    total_charge_bcm4b_cut = charge_raw[4];
+    total_charge_bcm4c_cut = charge_raw[5];
+
+    follow_npoll++;
+    
+    gSystem->Sleep(follow_poll_sec*1000);
+  }
+
+  //----run finished: final analysis (same as run_data_analysis())----
+  CalcEff();
+  ApplyWeight();
+
+  WriteHist();
+  WriteOfflineReport();
+  WriteReportSummary();   
+  WriteTimeSlices();
+  WriteBCMScan();
+  CombineHistos();
+
+  // --- online plot book (shift crew) ---
+  MakePlots();
+  //------------------
+  
+}
+
 //______________________________________________________________________________
 void baseAnalyzer::run_cafe_scalers()
 {
@@ -9102,6 +9870,8 @@ void baseAnalyzer::run_cafe_scalers()
   ScalerEventLoop();       
   CalcEff();
   WriteOfflineReport();
+  WriteTimeSlices();
+  WriteBCMScan();
 
   //------------------
   
@@ -9,6 +9,7 @@ Date Created: August 22, 2020
 
 #include "./UTILS/parse_utils.h" //useful C++ string parsing utilities
 #include "./UTILS/hist_utils.h" //useful C++ histogram bin extraction utility
+#include "./UTILS/summary_utils.h" //run-summary (.csv) store: locked, de-duplicated run rows
 #include <string>
 
 class baseAnalyzer
@@ -29,6 +30,7 @@ public:
   void run_data_analysis();
   void run_simc_analysis();
   void run_cafe_scalers(); // mainly for generating cafe output file (for bcm calib runs)
+  void run_data_follow();  // online: follow a growing replay ROOTfile, analyzing only the newly appended entries every poll
   
   //Function prototypes
   void Init(); 
@@ -49,18 +51,31 @@ public:
   void WriteOnlineReport();
   void WriteOfflineReport();
   void WriteReportSummary();
+  void WriteTimeSlices();
+  void WriteBCMScan();
   void CombineHistos();
   
   //void CalcRadCorr(); 
   //void ApplyRadCorr();
   //void ChargeNorm(); 
   void RandSub(); //Apply subtraction of random coincidence background
+  void AddRandHist(TH1F *&h_real);  //register a histogram for random coincidence background subtraction
+  void AddRandHist(TH2F *&h_real);
+  void SetRandFill(Bool_t rand_flag); //swap registered histograms to their *_rand twin (or back)
+  void FillCoinHistos();
+  void GetRandSubYield(TString hist_name, Double_t &total, Double_t &total_err, Double_t &real, Double_t &real_err, Double_t &rand, Double_t &rand_err);
   //void GetAsymmetry();
   
   // Helper Functions
   void GetPeak();
+  void AddTimeSlice(Double_t t_start);
+  void SetBCMScan(string bcm_list, string thrs_list);
+  template<class T> void GrowArray(T *&arr, Long64_t n_old, Long64_t n_new);
   void CollimatorStudy();
   void MakePlots();
+  void AddPlotPage(Int_t nx, Int_t ny, Bool_t logy, vector< vector<TString> > pads);
+  void DrawPlotPage(Int_t ipage, TCanvas *c);
+  TH1 *GetPlotHist(TString hname);
   Double_t GetLuminosity(TString user_input="");
 
     
@@ -347,6 +362,7 @@ protected:
   
   //Declare TFile Pointers (reading/writing ROOTfiles)
   TFile *inROOT;
+  TFile *inROOT_scaler;  // separate handle for the scaler tree (re-opened every poll in follow mode)
   TFile *outROOT;
 
   //Input ROOTfile Name (to be read)
@@ -1285,60 +1301,26 @@ protected:
   TH2F *H_exfp_vs_eyfp;
   
 
-  // ------- Selected Histograms for Random Coincidence Background Subtraction --------
+  // ------- Random Coincidence Background Subtraction --------
 
   // NOTE: Nomenclature clarification 
   // *_rand -> random coincidence selection (sample selected outside the main coin. peak taken
   // to be representative of randoms underneath main coin. peak)  
   // *_rand_sub -> "true" coincidences after having subtracted the estimated randoms beneath the main peak
 
-  //Coin. Time
-  TH1F *H_ep_ctime_rand;
-  TH1F *H_ep_ctime_rand_sub;
-
-  // invariant mass
-  TH1F *H_W_rand;
-  TH1F *H_W_rand_sub;
-
-  // 4-momentum transfer
-  TH1F *H_Q2_rand;
-  TH1F *H_Q2_rand_sub;
-
-  // x-Bjorken
-  TH1F *H_xbj_rand;
-  TH1F *H_xbj_rand_sub;
-
-  // energy transfer
-  TH1F *H_nu_rand;
-  TH1F *H_nu_rand_sub;
-
-  // 3-momentum |q|
-  TH1F *H_q_rand;
-  TH1F *H_q_rand_sub;
-
-  // missing energy 
-  TH1F *H_Em_rand;
-  TH1F *H_Em_rand_sub;
+  // Every histogram registered with AddRandHist() gets a *_rand and a *_rand_sub twin. The *_rand twin is filled
+  // by the same FillCoinHistos() block as the reals (SetRandFill() points the member histogram to its twin while
+  // filling the accidental window), and the *_rand_sub twin is computed once, after the event loop, by RandSub()
+  template<class H>
+  struct RandHist {
+    H **slot;   // address of the member histogram pointer used in FillCoinHistos()
+    H  *real;   // main coin. peak selection
+    H  *rand;   // accidental coin. selection
+    H  *sub;    // random-subtracted (real - scaled rand)
+  };
 
-  // nuclear missing energy
-  TH1F *H_Em_nuc_rand;
-  TH1F *H_Em_nuc_rand_sub;
-
-  // missing momentum
-  TH1F *H_Pm_rand;
-  TH1F *H_Pm_rand_sub;
-
-  // missing mass
-  TH1F *H_MM_rand;
-  TH1F *H_MM_rand_sub;
-
-  // in-plane angle between detected hadron and |q|
-  TH1F *H_thxq_rand;
-  TH1F *H_thxq_rand_sub;
-
-  // in-plane angle between residual nucleus and |q|
-  TH1F *H_thrq_rand;
-  TH1F *H_thrq_rand_sub;
+  vector< RandHist<TH1F> > rand_H1;
+  vector< RandHist<TH2F> > rand_H2;
 
   
   //-----------END CREATE HISTOGRAMS-----------
@@ -1528,7 +1510,7 @@ protected:
   Float_t eP_mult;           
 
   //Scale factor variables (for random coincidence scaling / subtraction)
-  Float_t P_scale_factor;
+  Float_t P_scale_factor = 0;
 
   //SHMS Calorimeter EtotTrackNorm (e- selection)
   Bool_t petot_trkNorm_pidCut_flag;
@@ -2124,6 +2106,92 @@ protected:
   //---------END SCALER-RELATED VARIABLES----------
 
 
+  //--------TIME-SLICED (PER SCALER INTERVAL) YIELD / NORMALIZATION----------
+  // Accumulated in the same pass as the run totals (see ScalerEventLoop(), EventLoop()) and written
+  // by WriteTimeSlices(). Only scaler intervals that passed the BCM current cut are accumulated.
+  Bool_t   time_slice_flag = 0;     // turn ON/OFF the time-sliced table (set_basic_cuts.inp)
+  Double_t time_slice_width = 0.;   // slice width [sec] (<= 0: one slice per scaler interval)
+  TString  output_TimeSliceFileName;
+  
+  Int_t *scal_slice;                // time slice index of each scaler read
+  Int_t nslices = 0;
+  Int_t islice = 0;                 // time slice of the current event (used inside data loop)
+  Double_t prev_charge_bcm = 0.;    // previous scaler read charge of the user-selected BCM
+
+  vector<Double_t> ts_time_start;            // run time at start / end of slice [sec]
+  vector<Double_t> ts_time_end;
+  vector<Double_t> ts_time_bcm_cut;          // beam time [sec]
+  vector<Double_t> ts_charge_bcm_cut;        // charge of user-selected BCM [uC]
+  vector<Double_t> ts_trig_scaler_bcm_cut[6]; // TRIG1-6 scaler counts  (EDTM NOT subtracted)
+  vector<Double_t> ts_edtm_scaler_bcm_cut;
+  vector<Double_t> ts_trig_accp_bcm_cut[6];   // TRIG1-6 accepted (no EDTM, NOT pre-scale corrected)
+  vector<Double_t> ts_edtm_accp_bcm_cut;
+  vector<Double_t> ts_trig2_singles_accp;
+  vector<Double_t> ts_h_did, ts_h_should;    // tracking efficiency numerator / denominator
+  vector<Double_t> ts_p_did, ts_p_should;
+  vector<Double_t> ts_yield_total;           // events passing all cuts within the main coin. peak
+  vector<Double_t> ts_yield_rand;            // events passing all cuts within the accidentals window (NOT scaled)
+
+  //--------END TIME-SLICED YIELD / NORMALIZATION----------
+
+
+  //--------BCM CURRENT THRESHOLD SCAN (MULTIPLE BCMs / THRESHOLDS IN ONE PASS)----------
+  // Each scan point is a (BCM, threshold) pair. Every scaler read stores a bitmask (bit j set if scan point j
+  // passed), and the normalization / yield counters are accumulated per scan point in the same scaler and data
+  // pass as the nominal (bcm_type, bcm_thrs) cut (see ScalerEventLoop(), EventLoop(), WriteBCMScan()).
+  Bool_t   bcm_scan_flag = 0;       // turn ON/OFF the bcm threshold scan (set_basic_cuts.inp)
+  TString  output_BCMScanFileName;
+  static const Int_t nscan_max = 64; // one bit per scan point
+  
+  ULong64_t *scal_bcm_mask;         // scan points passed by each scaler read
+  Int_t nscan = 0;                  // number of scan points ( = n_bcm x n_thrs)
+  vector<TString>  bs_bcm_type;     // BCM name of each scan point
+  vector<Int_t>    bs_bcm_idx;      // BCM index of each scan point (0: BCM1, 1: BCM2, 2: BCM4A, 3: BCM4B, 4: BCM4C)
+  vector<Double_t> bs_bcm_thrs;     // current threshold of each scan point [uA]
+
+  vector<Double_t> bs_time_bcm_cut;          // beam time [sec]
+  vector<Double_t> bs_charge_bcm_cut;        // charge of the scan point BCM [uC]
+  vector<Double_t> bs_trig_scaler_bcm_cut[6]; // TRIG1-6 scaler counts  (EDTM NOT subtracted)
+  vector<Double_t> bs_edtm_scaler_bcm_cut;
+  vector<Double_t> bs_trig_accp_bcm_cut[6];   // TRIG1-6 accepted (no EDTM, NOT pre-scale corrected)
+  vector<Double_t> bs_edtm_accp_bcm_cut;
+  vector<Double_t> bs_h_did, bs_h_should;    // tracking efficiency numerator / denominator
+  vector<Double_t> bs_p_did, bs_p_should;
+  vector<Double_t> bs_yield_total;           // events passing all cuts within the main coin. peak
+  vector<Double_t> bs_yield_rand;            // events passing all cuts within the accidentals window (NOT scaled)
+
+  //--------END BCM CURRENT THRESHOLD SCAN----------
+
+
+  //--------FOLLOW (ONLINE) MODE (see run_data_follow())----------
+  // The replay ROOTfile is re-opened every follow_poll_sec, and ScalerEventLoop() / EventLoop() resume from the
+  // last scaler read / entry analyzed. Data events are only analyzed once their scaler read has been written out.
+  Bool_t   follow_flag = 0;
+  Bool_t   follow_last_poll = 0;      // set once the ROOTfile stopped growing for follow_timeout_sec
+  Int_t    follow_poll_sec = 60;      // [sec] between polls (set_basic_cuts.inp)
+  Int_t    follow_timeout_sec = 600;  // [sec] without new entries before the run is considered finished
+  Long64_t follow_min_entries = 50000;// entries required before the 1st pass (coin. time peak sample, see GetPeak()), set_basic_cuts.inp
+  Int_t    follow_npoll = 0;
+  Long64_t scal_entries_done = 0;     // scaler reads already analyzed
+  Long64_t ientry_done = 0;           // data entries already analyzed
+
+  //--------END FOLLOW (ONLINE) MODE----------
+
+
+  //--------ONLINE PLOT BOOK (see MakePlots())----------
+  // pages are described once (histogram names per pad), then rendered by forked workers (one .pdf per page) and merged
+  struct plot_page {
+    Int_t nx, ny;                      // canvas divisions
+    Bool_t logy;
+    vector< vector<TString> > pads;    // histogram names overlaid on each pad ( {total, real, rand} or {data} )
+  };
+  vector<plot_page> plot_book;
+  Int_t online_plots_nworkers = 4;     // parallel page renderers (set_basic_cuts.inp), <=1 : serial
+  TFile *simc_plots_file = NULL;       // SIMC histograms overlaid on data (if SIMC file exists)
+
+  //--------END ONLINE PLOT BOOK----------
+
+
   //--------SCALER TTREE VARIABLE NAMES (DATA)---------
 
   Double_t Scal_evNum;
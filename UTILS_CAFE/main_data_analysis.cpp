@@ -7,7 +7,8 @@ void main_data_analysis(int     run           = 3243,   int evtNum           = -
 		   TString daq_mode      = "coin", TString e_arm        = "SHMS",
 		   TString analysis_type = "data", TString analysis_cut = "bcm_calib",
 		   Bool_t  hel_flag     = 0, TString bcm_type  = "BCM4A",  double bcm_thrs        = 5,
-		   TString trig_single = "trig2", TString trig_coin = "trig5",  Bool_t combine_runs    = 0		   
+		   TString trig_single = "trig2", TString trig_coin = "trig5",  Bool_t combine_runs    = 0,
+		   Bool_t  follow_run    = 0
 		   )
 {
 
@@ -26,6 +27,11 @@ void main_data_analysis(int     run           = 3243,   int evtNum           = -
       ba.run_cafe_scalers();
     }
 
+    // online analysis: follow the replay ROOTfile while it is being written
+    else if(follow_run){
+      ba.run_data_follow();
+    }
+    
     // standard data analysis
     else{
       ba.run_data_analysis();
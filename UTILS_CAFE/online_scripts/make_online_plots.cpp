@@ -1,6 +1,8 @@
 // Script to either plot ONLY DATA or make comparison between DATA and SIMC 
 // Histogram objects are retrieved from pre-existing ROOTfiles with pre-determined
 // histogram names
+// (NOTE: in the online (follow) mode, the online plot book is made in-process by baseAnalyzer::MakePlots(),
+//  this script is kept for making the plots offline from an existing ROOTfile)
 
 /* histogram categories:
 1) HMS/SHMS focal plane,
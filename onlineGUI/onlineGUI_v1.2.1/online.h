@@ -16,6 +16,7 @@
 #include <RQ_OBJECT.h>
 #include <TQObject.h>
 #include <vector>
+#include <map>
 #include <TString.h>
 #include <TCut.h>
 #include <TTimer.h>
@@ -24,6 +25,7 @@
 #include "TH3.h"
 
 #define UPDATETIME 2000
+#define PRECOMPUTETIME 100   // ms between background fills of hidden pages (one TreeDraw per tick)
 
 using namespace std;
 
@@ -63,6 +65,15 @@ struct drawcommand {
   TString objtitle;
 };
 
+struct treedrawcache {
+  // Filled TreeDraw histogram, and the entries already processed.
+  //  On refresh, only entries [lastentry, GetEntries()) are added in.
+  TH1                              *hist;
+  UInt_t                            iTree;
+  Long64_t                          firstentry;  // TreeEntries[iTree] when the cache was started
+  Long64_t                          lastentry;
+};
+
 class OnlineConfig {
   RQ_OBJECT("OnlineConfig");
   // Class that takes care of the config file
@@ -145,9 +156,14 @@ private:
   Bool_t                            fPrintOnly;
   Bool_t                            fRootOnly;
   Bool_t                            fFileAlive;
+  map <TString, treedrawcache>      fTreeCache;  // TreeDraw histograms, by unique histogram name
+  TTimer                           *precompute_timer;
+  UInt_t                            precompute_page;
+  UInt_t                            precompute_cmd;
+  UInt_t                            fNthreads;   // BatchFill() threads (online -j)
 
 public:
-  OnlineGUI(OnlineConfig&,Bool_t,Bool_t,UInt_t RunNum=0);
+  OnlineGUI(OnlineConfig&,Bool_t,Bool_t,UInt_t RunNum=0,UInt_t nthreads=0);
   void CreateGUI(const TGWindow *p, UInt_t w, UInt_t h);
   virtual ~OnlineGUI();
   void DoDraw();
@@ -163,6 +179,11 @@ public:
   UInt_t GetTreeIndexFromName(TString, RootFileObject *r);
   drawcommand fileObject2command(drawcommand,RootFileObject *r);
   void TreeDraw(drawcommand); 
+  Bool_t ParseTreeCommand(drawcommand,RootFileObject *r,TString&,TString&,TCut&,UInt_t&,TString&,TString&);
+  TH1* TreeFill(drawcommand, Int_t&, TString&, TString&, TCut&, UInt_t&, TString&);
+  void BatchFill(RootFileObject *r,Bool_t golden);
+  void ClearTreeCache();
+  void PrecomputePages();
   void HistDraw(drawcommand);
   void MacroDraw(drawcommand);
   void CanvasDraw(drawcommand,UInt_t);
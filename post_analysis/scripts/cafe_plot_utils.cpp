@@ -177,6 +177,19 @@ void cafe_plot_utils(){
 
   
   
+  //-------------------------------------
+  // BATCH RATIOS (single, SRC/MF, double)
+  //-------------------------------------
+  // brief: computes every tgt/tgt_ref ratio (MF, SRC), SRC/MF ratio and double ratio for a list of histograms in one call,
+  //        reading each .root file and scale factor only once, and writes all of them to a single .root file
+
+  /*
+  vector<string> tgt_all = {"Be9", "B10", "B11", "C12", "Ca48", "Fe54"};
+  vector<string> hist_all = {"randSub_plots/H_Pm_rand_sub", "randSub_plots/H_xbj_rand_sub", "randSub_plots/H_Q2_rand_sub"};
+  get_batch_ratios(tgt_all, "Ca40", hist_all, "cafe_ratios.root");
+  */
+
+
   //-------------------------
   // HISTOGRAM SINGLE RATIOS
   //-------------------------
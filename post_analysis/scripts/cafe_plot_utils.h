@@ -17,7 +17,116 @@
 
 #include "../../UTILS_CAFE/UTILS/parse_utils.h"
 #include "../../UTILS_CAFE/UTILS/read_csv.h"
+#include "../../UTILS_CAFE/UTILS/summary_utils.h"
 #include "../../UTILS_CAFE/UTILS/vector_operations.h"
+#include <algorithm>
+
+//___________________________________________________________________________
+// histogram file / object cache (process-wide)
+//
+// The ratio / overlay functions below request the same (file, histogram) pairs many times
+// (e.g. Ca40 MF is the denominator of every X/Ca40 ratio). Each _combined.root file is opened ONCE
+// (kept open, read-only), and each histogram is read ONCE into a master copy, detached from the file.
+//
+// cloning semantics:
+//   get_histo(fname, hist_name)         : returns a NEW clone of the master copy (owned by the caller, may be scaled / restyled freely)
+//   get_histo(fname, hist_name, false)  : returns the cached master copy itself (read-only: must NOT be modified or deleted by the caller)
+//
+// the caches are function-local statics (a single instance, even if this header is included in several translation units)
+//___________________________________________________________________________
+
+map<string, TFile*> &get_file_cache(){
+  static map<string, TFile*> file_cache;
+  return file_cache;
+}
+
+map<pair<string,string>, TH1F*> &get_hist_cache(){
+  static map<pair<string,string>, TH1F*> hist_cache;
+  return hist_cache;
+}
+
+//___________________________________________________________________________
+TFile *get_file(string fname=""){
+
+  // brief: returns the (cached) TFile of the given file name, opening it on first use only
+
+  map<string, TFile*> &file_cache = get_file_cache();
+  map<string, TFile*>::iterator it = file_cache.find(fname);
+  if(it!=file_cache.end()) return it->second;
+
+  cout << Form("FILE TO OPEN: %s", fname.c_str()) << endl;
+
+  TDirectory *dir_save = gDirectory;
+  TFile *file = TFile::Open(fname.c_str(), "READ");
+  dir_save->cd();
+
+  if(file==NULL || file->IsZombie()){
+    cout << Form("get_file: File %s failed to open ! ! !", fname.c_str()) << endl;
+    if(file) { delete file; file = NULL; }
+  }
+
+  file_cache[fname] = file;
+
+  return file;
+}
+
+//___________________________________________________________________________
+TH1F *get_histo(string fname="", string hist_name="", bool clone=true){
+
+  // brief: returns histogram (hist_name) from file (fname), read only once per (file, histogram) pair
+  // (see cloning semantics above). Returns NULL if the file or histogram is not found
+
+  static int nclones = 0;
+
+  map<pair<string,string>, TH1F*> &hist_cache = get_hist_cache();
+  pair<string,string> key(fname, hist_name);
+  map<pair<string,string>, TH1F*>::iterator it = hist_cache.find(key);
+
+  TH1F *H_master = NULL;
+
+  if(it!=hist_cache.end()) { H_master = it->second; }
+  else {
+
+    TFile *file = get_file(fname);
+
+    if(file) {
+      TH1F *H_hist = 0;
+      file->GetObject(hist_name.c_str(), H_hist);
+
+      if(H_hist) {
+	// detach master copy from the file (so it is not affected by any other reader of the file)
+	H_master = (TH1F*)H_hist->Clone(Form("%s_cache%d", H_hist->GetName(), (int)hist_cache.size()));
+	H_master->SetDirectory(0);
+	delete H_hist;
+      }
+      else { cout << Form("get_histo: histogram %s NOT found in %s ! ! !", hist_name.c_str(), fname.c_str()) << endl; }
+    }
+
+    hist_cache[key] = H_master;
+  }
+
+  if(H_master==NULL || !clone) return H_master;
+
+  TH1F *H_clone = (TH1F*)H_master->Clone(Form("%s_clone%d", H_master->GetName(), nclones++));
+  H_clone->SetDirectory(0);
+
+  return H_clone;
+}
+
+//___________________________________________________________________________
+void clear_histo_cache(){
+
+  // brief: delete cached histograms and close cached files (e.g. if the analyzed files were re-generated)
+
+  map<pair<string,string>, TH1F*> &hist_cache = get_hist_cache();
+  map<string, TFile*> &file_cache = get_file_cache();
+
+  for(map<pair<string,string>, TH1F*>::iterator it=hist_cache.begin(); it!=hist_cache.end(); ++it) { delete it->second; }
+  for(map<string, TFile*>::iterator it=file_cache.begin(); it!=file_cache.end(); ++it) { if(it->second) { it->second->Close(); delete it->second; } }
+
+  hist_cache.clear();
+  file_cache.clear();
+}
 
 //___________________________________________________________________________
 double get_header(string header="", string target="", string kin=""){
@@ -44,9 +153,12 @@ double get_header(string header="", string target="", string kin=""){
 
   cout << Form("FILE TO OPEN: %s", file_csv.c_str()) << endl;
 
+  // summary file is parsed only once (cached columnar table, see summary_utils.h)
+  summary_table &summary = summary_load(file_csv);
+  
   // return total charge (sums over charge for each run)
   if( header.compare("total_charge")==0 ){
-    vector<double> v_charge         = read_csv(file_csv.c_str(), "charge"); // mC
+    vector<double> v_charge         = summary.col("charge"); // mC
     double charge = vsum(v_charge);
     
     return charge;
@@ -55,7 +167,7 @@ double get_header(string header="", string target="", string kin=""){
   // return total yield (sums over real yield for each run)
   if( header.compare("real_yield")==0 ){
     
-    vector<double> v_real_Yield     = read_csv(file_csv, "real_Yield");
+    vector<double> v_real_Yield     = summary.col("real_Yield");
     double real_Yield = vsum(v_real_Yield);
     
     return real_Yield;
@@ -64,7 +176,7 @@ double get_header(string header="", string target="", string kin=""){
   // return total yield err ( root of the sum of errors ^{2} ) - basic error propagation for sum of variables  
   if( header.compare("real_yield_err")==0 ){
     
-    vector<double> v_real_Yield_err = read_csv(file_csv, "real_Yield_err");
+    vector<double> v_real_Yield_err = summary.col("real_Yield_err");
     double real_Yield_err = sqrt( vsum ( vpow(v_real_Yield_err, 2) ) ); // sqrt [  err_1^{2} + err_2^{2} + . .  . err_n^{2} ]
     
     return real_Yield_err;
@@ -74,8 +186,8 @@ double get_header(string header="", string target="", string kin=""){
   // return weighted avg HMS tracking (and error) efficiency (presumably tracking efficiency is ~ same for every run of the same kinematic)
   if( header.compare("hms_trk_eff")==0 || header.compare("hms_trk_eff_err")==0 ){
 
-    vector<double> v_hTrkEff        = read_csv(file_csv, "hTrkEff");
-    vector<double> v_hTrkEff_err    = read_csv(file_csv, "hTrkEff_err");
+    vector<double> v_hTrkEff        = summary.col("hTrkEff");
+    vector<double> v_hTrkEff_err    = summary.col("hTrkEff_err");
 
     //error in weighted average is passed by reference
     double hms_trk_eff_err = 0;          
@@ -97,8 +209,8 @@ double get_header(string header="", string target="", string kin=""){
   // return weighted avg SHMS tracking (and error) efficiency (presumably tracking efficiency is ~ same for every run of the same kinematic)
   if( header.compare("shms_trk_eff")==0 || header.compare("shms_trk_eff_err")==0 ){
 
-    vector<double> v_pTrkEff        = read_csv(file_csv, "pTrkEff");
-    vector<double> v_pTrkEff_err    = read_csv(file_csv, "pTrkEff_err");
+    vector<double> v_pTrkEff        = summary.col("pTrkEff");
+    vector<double> v_pTrkEff_err    = summary.col("pTrkEff_err");
 
     //error in weighted average is passed by reference
     double shms_trk_eff_err = 0;          
@@ -122,8 +234,8 @@ double get_header(string header="", string target="", string kin=""){
   if( header.compare("total_live_time")==0 || header.compare("total_live_time_err")==0 ){
 
    
-    vector<double> v_tLT            = read_csv(file_csv, "tLT");
-    vector<double> v_tLT_err        = read_csv(file_csv, "tLT_err_Bi");
+    vector<double> v_tLT            = summary.col("tLT");
+    vector<double> v_tLT_err        = summary.col("tLT_err_Bi");
 
     //error in weighted average is passed by reference
     double total_live_time_err = 0;          
@@ -160,12 +272,15 @@ double get_header(string header="", string target="", string kin=""){
 
   cout << Form("FILE TO OPEN: %s", file_csv.c_str() ) << endl;
 
-  double tgt_area_density = stod(split(FindString("target_areal_density", file_csv.c_str(), false, -1, true)[0], ':')[1]);
-  double transparency     = stod(split(FindString("transparency:", file_csv.c_str(),        false, -1, true)[0], ':')[1]);
+  // summary file is parsed only once (cached columnar table, see summary_utils.h)
+  summary_table &summary = summary_load(file_csv);
+  
+  double tgt_area_density = summary.param("target_areal_density");
+  double transparency     = summary.param("transparency");
 
-  double N     = stod(split(FindString("N:", file_csv.c_str(),        false, -1, true)[0], ':')[1]);
-  double Z     = stod(split(FindString("Z:", file_csv.c_str(),        false, -1, true)[0], ':')[1]);
-  double A     = stod(split(FindString("A:", file_csv.c_str(),        false, -1, true)[0], ':')[1]);
+  double N     = summary.param("N");
+  double Z     = summary.param("Z");
+  double A     = summary.param("A");
 
 
   if( var.compare("tgt_area_density")==0 ){
@@ -193,6 +308,55 @@ double get_header(string header="", string target="", string kin=""){
   
 }
 
+//___________________________________________________________________________
+struct scale_info
+{
+  // brief: histogram scale factor (and its components) of a given <target, kinematics>, see get_scale_factor()
+
+  double Q;                                  // total charge [mC]
+  double hms_trk_eff,  hms_trk_eff_err;      // weighted average of HMS  track efficiency
+  double shms_trk_eff, shms_trk_eff_err;     // weighted average of SHMS track efficiency
+  double total_LT,     total_LT_err;         // weighted average of total live time
+  double transparency;
+  double tgt_area_density;                   // [g/cm^2]
+
+  double scale_factor;                       // 1 / (Q * hms_trk_eff * shms_trk_eff * total_LT * transparency * tgt_area_density)
+  double scale_factor_rel_err;               // relative error (from efficiencies and live time only)
+};
+
+//___________________________________________________________________________
+scale_info &get_scale_factor(string target="", string kin=""){
+
+  /* brief: returns the histogram scale factor of a <target, kinematics> (total charge, track efficiencies, live time,
+     transparency and target areal density), computed ONCE from the summary files and cached for later calls
+  */
+
+  static map<pair<string,string>, scale_info> sf_cache;
+
+  pair<string,string> key(target, kin);
+  if(sf_cache.find(key)!=sf_cache.end()) return sf_cache[key];
+
+  scale_info &sf = sf_cache[key];
+
+  sf.Q                 = get_header("total_charge",        target, kin);
+  sf.hms_trk_eff       = get_header("hms_trk_eff",         target, kin);
+  sf.hms_trk_eff_err   = get_header("hms_trk_eff_err",     target, kin);
+  sf.shms_trk_eff      = get_header("shms_trk_eff",        target, kin);
+  sf.shms_trk_eff_err  = get_header("shms_trk_eff_err",    target, kin);
+  sf.total_LT          = get_header("total_live_time",     target, kin);
+  sf.total_LT_err      = get_header("total_live_time_err", target, kin);
+  sf.transparency      = get_param("transparency",         target, kin);
+  sf.tgt_area_density  = get_param("tgt_area_density",     target, kin);
+
+  sf.scale_factor = 1. / ( sf.Q * sf.hms_trk_eff * sf.shms_trk_eff * sf.total_LT * sf.transparency * sf.tgt_area_density );
+
+  sf.scale_factor_rel_err = sqrt( pow(sf.hms_trk_eff_err/sf.hms_trk_eff, 2) +
+				  pow(sf.shms_trk_eff_err/sf.shms_trk_eff, 2) +
+				  pow(sf.total_LT_err/sf.total_LT, 2) );
+
+  return sf;
+}
+
 //____________________________________________________________________________________________________
 void compare_histos( TString file_path="path/to/file1.root",
 		     vector<TString> hist_name={}, vector<int> clr={}, vector<TString> hist_leg={},
@@ -224,13 +388,6 @@ void compare_histos( TString file_path="path/to/file1.root",
   gStyle->SetLegendTextSize(0.03);
   
 
-  //Open  ROOT files;
-  TFile *file = NULL;
-
-  file = new TFile(file_path.Data());
-
-
-
   // declare canvas to draw overlay histos
   TCanvas *c = new TCanvas("c", "c", 900, 700);
 
@@ -241,12 +398,10 @@ void compare_histos( TString file_path="path/to/file1.root",
   // loop over all histogram names to be overlayed
   for(int i=0; i<hist_name.size(); i++) {
 
-    // declare 1D histos
-    TH1F *H_hist = 0;  
+    // get histogram objects (cached file / histogram, see get_histo())
+    TH1F *H_hist = get_histo(file_path.Data(), hist_name[i].Data());
+    if(H_hist==NULL) continue;
 
-    // get histogram objects
-    file->cd();
-    file->GetObject(hist_name[i].Data(), H_hist);
     // set histos aethetics
     H_hist->SetLineColor(clr[i]);
 
@@ -277,22 +432,25 @@ void compare_histos( TString file_path="path/to/file1.root",
     H_hist->SetTitleOffset(1.4, "Y");
   
     
+    // draw a copy owned by the canvas (the clone returned by get_histo() is deleted below)
+    TH1 *H_draw = 0;
+    
     if(norm) {
 
       if(i==0){
-	H_hist->DrawNormalized("histE0");
+	H_draw = H_hist->DrawNormalized("histE0");
       }
       else{
-	H_hist->DrawNormalized("sameshistE0");
+	H_draw = H_hist->DrawNormalized("sameshistE0");
       }
     }
 
     else{ 
       if(i==0){
-	H_hist->Draw("histE0");
+	H_draw = H_hist->DrawCopy("histE0");
       }
       else{
-	H_hist->Draw("sameshistE0");
+	H_draw = H_hist->DrawCopy("sameshistE0");
       }
     }
     
@@ -305,12 +463,12 @@ void compare_histos( TString file_path="path/to/file1.root",
     h_I = H_hist->IntegralAndError(1, nbins, h_Ierr);
 
 
-    leg->AddEntry(H_hist,Form("%s | Integral: %.1f \n", hist_leg[i].Data(), h_I),"f");
+    leg->AddEntry(H_draw,Form("%s | Integral: %.1f \n", hist_leg[i].Data(), h_I),"f");
 
 
     // draw legend
     leg->Draw();
-    //delete H_hist; H_hist=NULL;
+    delete H_hist; H_hist=NULL;
 
 
   } // end loop over hist names
@@ -351,22 +509,11 @@ void compare_histos( TString file1_path="path/to/file1.root", TString hist1="kin
   gStyle->SetLegendTextSize(0.03);
   
 
-  //Open  ROOT files;
-  TFile *file1 = NULL;
-  TFile *file2 = NULL;
-
-  file1 = new TFile(file1_path.Data());
-  file2 = new TFile(file2_path.Data());
+  // get histogram objects (cached files / histograms, see get_histo())
+  TH1F *H_hist1 = get_histo(file1_path.Data(), hist1.Data());
+  TH1F *H_hist2 = get_histo(file2_path.Data(), hist2.Data());
 
-  // declare 1D histos
-  TH1F *H_hist1 = 0;  
-  TH1F *H_hist2 = 0;
-
-  // get histogram objects
-  file1->cd();
-  file1->GetObject(hist1.Data(), H_hist1);
-  file2->cd();
-  file2->GetObject(hist2.Data(), H_hist2);
+  if(H_hist1==NULL || H_hist2==NULL) { delete H_hist1; delete H_hist2; return; }
 
   // set histos aethetics
   H_hist1->SetLineColor(kRed);
@@ -400,13 +547,14 @@ void compare_histos( TString file1_path="path/to/file1.root", TString hist1="kin
 
   TCanvas *c = new TCanvas("c", "c", 900, 700);
 
-  H_hist1->Draw("histE0");
-  H_hist2->Draw("sameshistE0");
+  // draw copies owned by the canvas (the clones returned by get_histo() are deleted below)
+  TH1 *H_draw1 = H_hist1->DrawCopy("histE0");
+  TH1 *H_draw2 = H_hist2->DrawCopy("sameshistE0");
 
 
   if(norm) {
-    H_hist1->DrawNormalized("histE0");
-    H_hist2->DrawNormalized("sameshistE0");
+    H_draw1 = H_hist1->DrawNormalized("histE0");
+    H_draw2 = H_hist2->DrawNormalized("sameshistE0");
   }
   
   // create legend ( displays hist legend label and integral counts)
@@ -417,11 +565,13 @@ void compare_histos( TString file1_path="path/to/file1.root", TString hist1="kin
   h1_I = H_hist1->IntegralAndError(1, nbins, h1_Ierr);
   h2_I = H_hist2->IntegralAndError(1, nbins, h2_Ierr);
   
-  leg->AddEntry(H_hist1,Form("%s | Integral: %.3f", hist1_leg.Data(), h1_I),"f");
-  leg->AddEntry(H_hist2,Form("%s | Integral: %.3f", hist2_leg.Data(), h2_I));
+  leg->AddEntry(H_draw1,Form("%s | Integral: %.3f", hist1_leg.Data(), h1_I),"f");
+  leg->AddEntry(H_draw2,Form("%s | Integral: %.3f", hist2_leg.Data(), h2_I));
   // draw legend
   leg->Draw();
-  
+
+  delete H_hist1; H_hist1=NULL;
+  delete H_hist2; H_hist2=NULL;
   
 }
 
@@ -566,18 +716,9 @@ void overlay_nuclei(vector<string> tgt={}, vector<int> clr={}, string kin="", st
     // generic file name with specific target, kinematic
     fname = Form(ANALYZED_COMBINED"pass1/cafe_prod_%s_%s_combined.root", tgt[i].c_str(), kin.c_str());
 
-    cout << Form("FILE TO OPEN: %s", fname.c_str()) << endl;
-
-    cout << "fname = " << fname << endl;
-    cout << clr[i] << endl;
-    // read TFile
-    TFile *file = NULL;
-    file = new TFile(fname.c_str());
-  
-    TH1F *H_hist =0;
-    
-    file->cd();
-    file->GetObject(hist_name.c_str(), H_hist);
+    // get histogram object (cached file / histogram, see get_histo())
+    TH1F *H_hist = get_histo(fname, hist_name);
+    if(H_hist==NULL) continue;
 
     // set histos aethetics
     H_hist->SetLineColor(clr[i]);
@@ -612,13 +753,16 @@ void overlay_nuclei(vector<string> tgt={}, vector<int> clr={}, string kin="", st
     H_hist->SetStats(0);
     // changed to canvas and draw
     c->cd();
-    if(tgt.size()==1) { H_hist->DrawNormalized("histE0") ;}
+    TH1 *H_draw = 0;  // normalized copy owned by the canvas
+    if(tgt.size()==1) { H_draw = H_hist->DrawNormalized("histE0") ;}
     else{
-      H_hist->DrawNormalized("sameshistE0");
+      H_draw = H_hist->DrawNormalized("sameshistE0");
     }
 
     // add legend entry
-    leg->AddEntry(H_hist,Form("%s %s", tgt[i].c_str(), kin.c_str()),"f");
+    leg->AddEntry(H_draw,Form("%s %s", tgt[i].c_str(), kin.c_str()),"f");
+
+    delete H_hist; H_hist=NULL;
 
   }
 
@@ -649,33 +793,15 @@ vector<TH1F*> get_single_ratios(string tgtA="",  string kinA="", string tgtB="",
   // get info from summary files (for scaling histograms)
   //-------------------------------------------------------
 
-  // total charge
-  Q_A  = get_header("total_charge", tgtA.c_str(),  kinA.c_str());    
-  Q_B = get_header("total_charge", tgtB.c_str(),  kinB.c_str());
-
-  // weighted average of HMS track efficiency
-  hms_trk_eff_A   = get_header("hms_trk_eff",  tgtA.c_str(), kinA.c_str() );
-  hms_trk_eff_B   = get_header("hms_trk_eff",  tgtB.c_str(), kinB.c_str() );    
-
-  // weighted average of SHMS track efficiency
-  shms_trk_eff_A  = get_header("shms_trk_eff", tgtA.c_str(), kinA.c_str() );
-  shms_trk_eff_B  = get_header("shms_trk_eff", tgtB.c_str(), kinB.c_str() );
-
-  // weighted average of total live time
-  total_LT_A      = get_header("total_live_time", tgtA.c_str(),  kinA.c_str());
-  total_LT_B      = get_header("total_live_time", tgtB.c_str(),  kinB.c_str());
-
-  // transparencies
-  transparency_A  = get_param("transparency", tgtA.c_str(),  kinA.c_str());
-  transparency_B  = get_param("transparency", tgtB.c_str(),  kinB.c_str());
+  // scale factors are computed once per <target, kinematics> (cached, see get_scale_factor())
+  scale_info &sf_A = get_scale_factor(tgtA, kinA);
+  scale_info &sf_B = get_scale_factor(tgtB, kinB);
 
-  // target areal density [g/cm^2]
-  tgt_area_density_A  = get_param("tgt_area_density", tgtA.c_str(),  kinA.c_str());
-  tgt_area_density_B  = get_param("tgt_area_density", tgtB.c_str(),  kinB.c_str());
+  Q_A = sf_A.Q;  hms_trk_eff_A = sf_A.hms_trk_eff;  shms_trk_eff_A = sf_A.shms_trk_eff;  total_LT_A = sf_A.total_LT;
+  transparency_A = sf_A.transparency;  tgt_area_density_A = sf_A.tgt_area_density;  scale_factor_A = sf_A.scale_factor;
 
-  // putting everyting together . . .  
-  scale_factor_A   = 1. / ( Q_A * hms_trk_eff_A * shms_trk_eff_A * total_LT_A * transparency_A * tgt_area_density_A) ;
-  scale_factor_B   = 1. / ( Q_B * hms_trk_eff_B * shms_trk_eff_B * total_LT_B * transparency_B * tgt_area_density_B) ;
+  Q_B = sf_B.Q;  hms_trk_eff_B = sf_B.hms_trk_eff;  shms_trk_eff_B = sf_B.shms_trk_eff;  total_LT_B = sf_B.total_LT;
+  transparency_B = sf_B.transparency;  tgt_area_density_B = sf_B.tgt_area_density;  scale_factor_B = sf_B.scale_factor;
 
   // PRINT OUT scale factor and its components for sanity checking
   cout << "" << endl;
@@ -707,39 +833,21 @@ vector<TH1F*> get_single_ratios(string tgtA="",  string kinA="", string tgtB="",
   string fname_A = Form(ANALYZED_COMBINED"pass1/cafe_prod_%s_%s_combined.root", tgtA.c_str(), kinA.c_str());
   string fname_B = Form(ANALYZED_COMBINED"pass1/cafe_prod_%s_%s_combined.root", tgtB.c_str(), kinB.c_str());
 
-  cout << Form("FILES TO OPEN: \n%s\n%s", fname_A.c_str(), fname_B.c_str() ) << endl;
+  // get histogram objects (cached files / histograms, see get_histo()):
+  // each call returns a new clone, so scaling does not affect the cached copy (or the A/B histograms of other ratios)
+  TH1F *H_hist_A = get_histo(fname_A, hist_name);
+  TH1F *H_hist_B = get_histo(fname_B, hist_name);
 
-  // define TFile
-  TFile *file_A  = NULL;
-  TFile *file_B = NULL;
-    
-  
-  TH1F *H_hist_A  = 0;  
-  TH1F *H_hist_B = 0;
-  //TH1F *H_hist_R = 0;
-    
-  // read TFile
-  file_A = new TFile(fname_A.c_str());
-  file_B = new TFile(fname_B.c_str());
-
-   
-  // get histogram objects
-  file_A->cd(); 
-  file_A->GetObject(hist_name.c_str(), H_hist_A);
+  if(H_hist_A==NULL || H_hist_B==NULL) { delete H_hist_A; delete H_hist_B; return vector<TH1F*>(); }
 
   // scale histogram appropiately
   H_hist_A->Scale(scale_factor_A);
-  
-    
-  file_B->cd();
-  file_B->GetObject(hist_name.c_str(), H_hist_B);
-
-  // scale histogram appropiately
   H_hist_B->Scale(scale_factor_B);
   
 
   // calculate the ratio (A * scale_factor / (B * scale_factor) )
-  TH1F *H_hist_R = (TH1F*)H_hist_A->Clone("H_hist_R");
+  TH1F *H_hist_R = (TH1F*)H_hist_A->Clone(Form("%s_R", H_hist_A->GetName()));
+  H_hist_R->SetDirectory(0);
   H_hist_R->Divide(H_hist_A, H_hist_B);
 
   if(show_histos) {
@@ -834,6 +942,181 @@ vector<TH1F*> get_single_ratios(string tgtA="",  string kinA="", string tgtB="",
 }
 
 
+//_______________________________________________________________________________________________
+bool same_binning(TH1F *H_1=0, TH1F *H_2=0){
+
+  // brief: true if two histograms have the same binning (required for bin-by-bin ratios)
+
+  return ( H_1->GetNbinsX()==H_2->GetNbinsX() &&
+	   fabs(H_1->GetXaxis()->GetXmin() - H_2->GetXaxis()->GetXmin()) < 1e-9 &&
+	   fabs(H_1->GetXaxis()->GetXmax() - H_2->GetXaxis()->GetXmax()) < 1e-9 );
+}
+
+//_______________________________________________________________________________________________
+void get_batch_ratios(vector<string> tgt={}, string tgt_ref="Ca40", vector<string> hist_name={},
+		      string out_fname="cafe_ratios.root", vector<string> kin={"MF", "SRC"}){
+
+  /*
+    brief: batch version of get_single_ratios(), which computes ALL CaFe ratios of a list of histograms in one pass:
+
+    for every target (tgt) and reference target (tgt_ref), and every histogram in hist_name:
 
+      single ratios : tgt_kin / tgt_ref_kin                                    (e.g. Ca48 MF / Ca40 MF,  Fe54 SRC / Ca40 SRC)
+      SRC/MF ratios : tgt_SRC / tgt_MF                                         (for every target, including tgt_ref)
+      double ratios : (tgt_SRC / tgt_MF) / (tgt_ref_SRC / tgt_ref_MF)
 
+    Every <target, kinematics> histogram is read once (see get_histo()) and scaled once by its scale factor
+    (computed once, see get_scale_factor()).  The binned ratios carry the propagated (statistical) bin errors;
+    the integrated ratios additionally include the scale factor errors (track efficiencies and live time),
+    added in quadrature (correlations between numerator and denominator are neglected).
 
+    Binned ratios are only made for histograms of the same binning (e.g. SRC/MF may differ), integrated ratios always.
+
+    All results are written to a single ROOT file (out_fname):
+      <hist>/single_ratios/<kin>/   : H_<tgt>_<kin>_over_<tgt_ref>_<kin>
+      <hist>/src_mf_ratios/         : H_<tgt>_SRC_over_<tgt>_MF
+      <hist>/double_ratios/         : H_<tgt>_over_<tgt_ref>_SRC_MF
+      <hist>/scaled_histos/         : H_<tgt>_<kin> (scaled)
+      integrated_ratios (TTree)     : hist, ratio_type, numerator, denominator, R, R_err
+
+    example:
+    vector<string> tgt = {"Be9", "B10", "B11", "C12", "Ca48", "Fe54"};
+    get_batch_ratios(tgt, "Ca40", {"randSub_plots/H_Pm_rand_sub", "randSub_plots/H_xbj_rand_sub"}, "cafe_ratios.root");
+  */
+
+  // all targets (reference target included, for its SRC/MF ratio)
+  vector<string> tgt_all = tgt;
+  if(find(tgt_all.begin(), tgt_all.end(), tgt_ref)==tgt_all.end()) tgt_all.push_back(tgt_ref);
+
+  bool has_src_mf = find(kin.begin(), kin.end(), "MF")!=kin.end() && find(kin.begin(), kin.end(), "SRC")!=kin.end();
+
+  TFile *out_file = new TFile(out_fname.c_str(), "RECREATE");
+
+  // integrated ratios
+  TTree *T = new TTree("integrated_ratios", "CaFe integrated ratios");
+  string b_hist, b_type, b_numer, b_denom;
+  double b_R, b_R_err;
+  T->Branch("hist",        &b_hist);
+  T->Branch("ratio_type",  &b_type);
+  T->Branch("numerator",   &b_numer);
+  T->Branch("denominator", &b_denom);
+  T->Branch("R",           &b_R);
+  T->Branch("R_err",       &b_R_err);
+
+  cout << "" << endl;
+  cout << "#---------------------------" << endl;
+  cout << " CaFe Batch Ratios " << endl;
+  cout << "#---------------------------" << endl;
+  cout << Form("%-30s %-10s %-12s %-12s %12s %12s", "hist", "type", "numerator", "denominator", "R", "R_err") << endl;
+
+  for(unsigned int ih=0; ih<hist_name.size(); ih++){
+
+    // scaled histograms and integrated (scaled) yields, per <target, kinematics>
+    map<pair<string,string>, TH1F*>  H_scaled;
+    map<pair<string,string>, double> Y, Y_rel_err;
+
+    for(unsigned int it=0; it<tgt_all.size(); it++){
+      for(unsigned int ik=0; ik<kin.size(); ik++){
+
+	pair<string,string> key(tgt_all[it], kin[ik]);
+
+	TH1F *H = get_histo(Form(ANALYZED_COMBINED"pass1/cafe_prod_%s_%s_combined.root", tgt_all[it].c_str(), kin[ik].c_str()), hist_name[ih]);
+	if(H==NULL) continue;
+
+	scale_info &sf = get_scale_factor(tgt_all[it], kin[ik]);
+	H->Scale(sf.scale_factor);
+	H->SetName(Form("H_%s_%s", tgt_all[it].c_str(), kin[ik].c_str()));
+	H_scaled[key] = H;
+
+	double I_err = 0;
+	double I     = H->IntegralAndError(1, H->GetNbinsX(), I_err);
+	Y[key]         = I;
+	Y_rel_err[key] = I!=0 ? sqrt( pow(I_err/I, 2) + pow(sf.scale_factor_rel_err, 2) ) : 0.;
+      }
+    }
+
+    // output directory of this histogram ( "randSub_plots/H_Pm_rand_sub" --> "randSub_plots_H_Pm_rand_sub" )
+    TString hdir = hist_name[ih];
+    hdir.ReplaceAll("/", "_");
+    out_file->cd();
+    TDirectory *dir = out_file->mkdir(hdir.Data());
+
+    dir->mkdir("scaled_histos")->cd();
+    for(map<pair<string,string>, TH1F*>::iterator it=H_scaled.begin(); it!=H_scaled.end(); ++it) { it->second->Write(); }
+
+    // helper: store a binned ratio (if same binning) and an integrated ratio
+    // (numerator / denominator are lists of <target, kin> multiplied / divided, e.g. double ratio: {A_SRC, ref_MF} / {A_MF, ref_SRC})
+    auto add_ratio = [&](string type, string name, string numer, string denom,
+			 vector<pair<string,string> > num, vector<pair<string,string> > den){
+
+      vector<pair<string,string> > all = num;
+      all.insert(all.end(), den.begin(), den.end());
+      for(unsigned int i=0; i<all.size(); i++){ if(H_scaled.find(all[i])==H_scaled.end()) return; }
+
+      // integrated ratio (relative errors added in quadrature)
+      double R = 1., R_rel_err2 = 0.;
+      for(unsigned int i=0; i<num.size(); i++){ R *= Y[num[i]]; R_rel_err2 += pow(Y_rel_err[num[i]], 2); }
+      for(unsigned int i=0; i<den.size(); i++){ R /= Y[den[i]]; R_rel_err2 += pow(Y_rel_err[den[i]], 2); }
+
+      b_hist = hist_name[ih]; b_type = type; b_numer = numer; b_denom = denom;
+      b_R = R; b_R_err = fabs(R) * sqrt(R_rel_err2);
+      T->Fill();
+
+      cout << Form("%-30s %-10s %-12s %-12s %12.4f %12.4f", b_hist.c_str(), b_type.c_str(), b_numer.c_str(), b_denom.c_str(), b_R, b_R_err) << endl;
+
+      // binned ratio
+      for(unsigned int i=1; i<all.size(); i++){ if(!same_binning(H_scaled[all[0]], H_scaled[all[i]])) return; }
+
+      TH1F *H_R = (TH1F*)H_scaled[num[0]]->Clone(name.c_str());
+      H_R->SetDirectory(0);
+      H_R->SetTitle(Form("%s / %s", numer.c_str(), denom.c_str()));
+      for(unsigned int i=1; i<num.size(); i++){ H_R->Multiply(H_scaled[num[i]]); }
+      for(unsigned int i=0; i<den.size(); i++){ H_R->Divide(H_scaled[den[i]]); }
+      H_R->Write();
+      delete H_R;
+    };
+
+    // single ratios: tgt_kin / tgt_ref_kin
+    TDirectory *single_dir = dir->mkdir("single_ratios");
+    for(unsigned int ik=0; ik<kin.size(); ik++){
+
+      single_dir->mkdir(kin[ik].c_str())->cd();
+
+      for(unsigned int it=0; it<tgt.size(); it++){
+	if(tgt[it]==tgt_ref) continue;
+	add_ratio("single", Form("H_%s_%s_over_%s_%s", tgt[it].c_str(), kin[ik].c_str(), tgt_ref.c_str(), kin[ik].c_str()),
+		  tgt[it]+"_"+kin[ik], tgt_ref+"_"+kin[ik], { {tgt[it], kin[ik]} }, { {tgt_ref, kin[ik]} });
+      }
+    }
+
+    if(has_src_mf) {
+
+      // SRC/MF ratios: tgt_SRC / tgt_MF
+      dir->mkdir("src_mf_ratios")->cd();
+      for(unsigned int it=0; it<tgt_all.size(); it++){
+	add_ratio("src_mf", Form("H_%s_SRC_over_%s_MF", tgt_all[it].c_str(), tgt_all[it].c_str()),
+		  tgt_all[it]+"_SRC", tgt_all[it]+"_MF", { {tgt_all[it], "SRC"} }, { {tgt_all[it], "MF"} });
+      }
+
+      // double ratios: (tgt_SRC / tgt_MF) / (tgt_ref_SRC / tgt_ref_MF)
+      dir->mkdir("double_ratios")->cd();
+      for(unsigned int it=0; it<tgt.size(); it++){
+	if(tgt[it]==tgt_ref) continue;
+	add_ratio("double", Form("H_%s_over_%s_SRC_MF", tgt[it].c_str(), tgt_ref.c_str()),
+		  tgt[it]+"_SRC/MF", tgt_ref+"_SRC/MF",
+		  { {tgt[it], "SRC"}, {tgt_ref, "MF"} }, { {tgt[it], "MF"}, {tgt_ref, "SRC"} });
+      }
+    }
+
+    // scaled clones are owned here
+    for(map<pair<string,string>, TH1F*>::iterator it=H_scaled.begin(); it!=H_scaled.end(); ++it) { delete it->second; }
+
+  } // end loop over histograms
+
+  out_file->cd();
+  T->Write();
+  out_file->Close();
+  delete out_file;
+
+  cout << Form("ratios written to: %s", out_fname.c_str()) << endl;
+}